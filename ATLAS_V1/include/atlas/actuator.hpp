@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include "pros/adi.hpp"
+#include "pros/motors.hpp"
+
+namespace atlas {
+/** an unchanged command is sent again after this long, in case the device missed it or was reconnected, in ms */
+constexpr std::uint32_t REFRESH_PERIOD = 500;
+
+/**
+ * @brief A motor that only sends a command when it changes
+ *
+ * Every command is a write on the smart port bus, which delays the sensor reads sharing it. Loops usually send the
+ * same command every update, often 0, so repeated commands are skipped. They are still resent every REFRESH_PERIOD,
+ * so a motor that lost power comes back doing what it was told.
+ */
+class CachedMotor {
+    public:
+        /**
+         * @brief Create a new CachedMotor
+         *
+         * @param motor the motor to command
+         */
+        CachedMotor(pros::Motor* motor);
+        /**
+         * @brief Move the motor, like pros::Motor::move
+         *
+         * @param power from -127 to 127
+         */
+        void move(int power);
+        /**
+         * @brief Move the motor at a voltage, like pros::Motor::move_voltage
+         *
+         * @param voltage from -12000 to 12000, in mV
+         */
+        void moveVoltage(int voltage);
+        /**
+         * @brief Move the motor at a velocity with its internal velocity controller, like pros::Motor::move_velocity
+         *
+         * @param velocity in rpm, limited by the gearset
+         */
+        void moveVelocity(int velocity);
+        /**
+         * @brief Get the motor being commanded, for reading its sensors
+         */
+        pros::Motor* getMotor() const;
+    private:
+        /**
+         * @brief The kind of the last command
+         */
+        enum class Mode { NONE, POWER, VOLTAGE, VELOCITY };
+
+        /**
+         * @brief Check if a command has to be sent, and remember it if so
+         *
+         * @param mode kind of the command
+         * @param value value of the command
+         * @return true the command is new, or the last command is due to be refreshed
+         */
+        bool update(Mode mode, int value);
+
+        pros::Motor* motor;
+        Mode mode = Mode::NONE;
+        int value = 0;
+        std::uint32_t lastWrite = 0;
+};
+
+/**
+ * @brief A pneumatic piston that only sends a command when it changes
+ *
+ * Same as CachedMotor, for pistons on the 3-wire ports or an expander.
+ */
+class CachedPneumatics {
+    public:
+        /**
+         * @brief Create a new CachedPneumatics
+         *
+         * @param pneumatics the piston to command
+         */
+        CachedPneumatics(pros::adi::Pneumatics* pneumatics);
+        /**
+         * @brief Extend or retract the piston
+         *
+         * @param extended true to extend, false to retract
+         */
+        void set(bool extended);
+        /**
+         * @brief Extend the piston if it is retracted, and retract it if it is extended
+         */
+        void toggle();
+        /**
+         * @brief Check if the piston was last told to extend
+         */
+        bool isExtended() const;
+    private:
+        pros::adi::Pneumatics* pneumatics;
+        bool extended;
+        std::uint32_t lastWrite = 0;
+};
+} // namespace atlas
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include "atlas/actuator.hpp" // IWYU pragma: keep
+#include "atlas/colorsort.hpp" // IWYU pragma: keep
+#include "atlas/controller.hpp" // IWYU pragma: keep
+#include "atlas/drivecurve.hpp" // IWYU pragma: keep
+#include "atlas/ekf.hpp" // IWYU pragma: keep
+#include "atlas/exitcondition.hpp" // IWYU pragma: keep
+#include "atlas/intake.hpp" // IWYU pragma: keep
+#include "atlas/matrix.hpp" // IWYU pragma: keep
+#include "atlas/particlefilter.hpp" // IWYU pragma: keep
+#include "atlas/path.hpp" // IWYU pragma: keep
+#include "atlas/power.hpp" // IWYU pragma: keep
+#include "atlas/profile.hpp" // IWYU pragma: keep
+#include "atlas/relocalize.hpp" // IWYU pragma: keep
+#include "atlas/trajectory.hpp" // IWYU pragma: keep
+#include "atlas/vision.hpp" // IWYU pragma: keep
+#include "atlas/chassis/chassis.hpp" // IWYU pragma: keep
+#include "atlas/chassis/odom.hpp" // IWYU pragma: keep
@@ -0,0 +1,606 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/timer.hpp"
+#include "pros/gps.hpp"
+#include "atlas/drivecurve.hpp"
+#include "atlas/exitcondition.hpp"
+#include "atlas/path.hpp"
+#include "atlas/profile.hpp"
+#include "atlas/relocalize.hpp"
+
+namespace atlas {
+/**
+ * @brief The sensors used for odometry
+ *
+ * Same as lemlib::OdomSensors, with an optional GPS and distance sensors that are fused with the tracking wheels and
+ * IMU
+ */
+class OdomSensors : public lemlib::OdomSensors {
+    public:
+        /**
+         * @brief Create a new OdomSensors object
+         *
+         * @param vertical1 pointer to the first vertical tracking wheel
+         * @param vertical2 pointer to the second vertical tracking wheel
+         * @param horizontal1 pointer to the first horizontal tracking wheel
+         * @param horizontal2 pointer to the second horizontal tracking wheel
+         * @param imu pointer to the IMU
+         * @param gps pointer to the GPS. The GPS reports its pose on the field, so poses set with Chassis::setPose
+         * have to be in the same frame: inches from the center of the field. nullptr by default
+         * @param distanceSensors distance sensors used to correct the pose against the field walls. Like the GPS,
+         * these need poses in the field frame. None by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * pros::Gps gps(5, 0.1, -0.05); // GPS on port 5, offset 0.1m right and 0.05m back from the tracking center
+         * atlas::OdomSensors sensors(&vertical1, nullptr, &horizontal1, nullptr, &imu, &gps);
+         * @endcode
+         * @code {.cpp}
+         * pros::Distance left_distance(3);
+         * pros::Distance back_distance(4);
+         * // no GPS, but a distance sensor facing left and one facing backwards
+         * atlas::OdomSensors sensors(&vertical1, nullptr, &horizontal1, nullptr, &imu, nullptr,
+         *                            {{&left_distance, -5, 0, -90}, {&back_distance, 0, -6, 180}});
+         * @endcode
+         */
+        OdomSensors(lemlib::TrackingWheel* vertical1, lemlib::TrackingWheel* vertical2,
+                    lemlib::TrackingWheel* horizontal1, lemlib::TrackingWheel* horizontal2, pros::Imu* imu,
+                    pros::Gps* gps = nullptr, std::vector<DistanceSensor> distanceSensors = {})
+            : OdomSensors(vertical1, vertical2, horizontal1, horizontal2,
+                          imu != nullptr ? std::vector<pros::Imu*> {imu} : std::vector<pros::Imu*> {}, gps,
+                          distanceSensors) {}
+        /**
+         * @brief Create a new OdomSensors object with several IMUs
+         *
+         * The change in heading of every IMU is averaged, which halves the noise with 4 IMUs. Each IMU has its drift
+         * estimated and removed whenever the tracking wheels show the robot is still.
+         *
+         * @param vertical1 pointer to the first vertical tracking wheel
+         * @param vertical2 pointer to the second vertical tracking wheel
+         * @param horizontal1 pointer to the first horizontal tracking wheel
+         * @param horizontal2 pointer to the second horizontal tracking wheel
+         * @param imus pointers to the IMUs
+         * @param gps pointer to the GPS. nullptr by default
+         * @param distanceSensors distance sensors used to correct the pose against the field walls. None by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * pros::Imu imu1(18);
+         * pros::Imu imu2(12);
+         * atlas::OdomSensors sensors(&vertical1, nullptr, &horizontal1, nullptr, {&imu1, &imu2});
+         * @endcode
+         */
+        OdomSensors(lemlib::TrackingWheel* vertical1, lemlib::TrackingWheel* vertical2,
+                    lemlib::TrackingWheel* horizontal1, lemlib::TrackingWheel* horizontal2,
+                    std::vector<pros::Imu*> imus, pros::Gps* gps = nullptr,
+                    std::vector<DistanceSensor> distanceSensors = {})
+            : lemlib::OdomSensors(vertical1, vertical2, horizontal1, horizontal2, imus.empty() ? nullptr : imus[0]),
+              imus(imus),
+              gps(gps),
+              distanceSensors(distanceSensors) {}
+
+        /** every IMU. The first is also stored in imu, for LemLib */
+        std::vector<pros::Imu*> imus;
+        pros::Gps* gps;
+        std::vector<DistanceSensor> distanceSensors;
+};
+
+/**
+ * @brief Handle to a calibration of the chassis, which may still be running
+ */
+class Calibration {
+    public:
+        /**
+         * @brief Create a new Calibration handle
+         *
+         * @param done flag set once the calibration is done
+         */
+        Calibration(std::shared_ptr<std::atomic<bool>> done);
+        /**
+         * @brief Check whether the calibration is done
+         *
+         * @return true the sensors are calibrated and odometry is running
+         * @return false the calibration is still running
+         */
+        bool isDone() const;
+        /**
+         * @brief Wait until the calibration is done
+         */
+        void waitUntilDone() const;
+    private:
+        std::shared_ptr<std::atomic<bool>> done;
+};
+
+/**
+ * @brief Path tracking algorithm used by Chassis::follow
+ */
+enum class Tracker {
+    PURE_PURSUIT, /** steer towards a lookahead point on the path */
+    RAMSETE /** track a time-parameterized trajectory with a Ramsete controller */
+};
+
+/**
+ * @brief Parameters for Chassis::follow
+ */
+struct FollowParams {
+        /** the path tracking algorithm to use. PURE_PURSUIT by default */
+        Tracker tracker = Tracker::PURE_PURSUIT;
+        /** Ramsete convergence gain, in rad^2/in^2. Larger values correct cross-track error more aggressively.
+         * 0.0013 by default, the usual 2 rad^2/m^2 */
+        float b = 0.0013;
+        /** Ramsete damping ratio, between 0 and 1. 0.7 by default */
+        float zeta = 0.7;
+        /** minimum pure pursuit lookahead distance, in inches. The lookahead adapts to the speed of the robot and the
+         * curvature of the path when both this and maxLookahead are set, and lookahead keyframes exported by path.jerryio
+         * are mapped between the two. 0 by default */
+        float minLookahead = 0;
+        /** maximum pure pursuit lookahead distance, in inches. 0 by default */
+        float maxLookahead = 0;
+        /** the largest the adaptive lookahead can be, as a fraction of the turn radius of the path ahead. 1 by
+         * default */
+        float curvatureGain = 1;
+};
+
+/**
+ * @brief Parameters for Chassis::turnToHeading
+ *
+ * Same as lemlib::TurnToHeadingParams, with the option to disable the motion profile
+ */
+struct TurnToHeadingParams {
+        /** the direction the robot should turn in. AUTO by default */
+        lemlib::AngularDirection direction = lemlib::AngularDirection::AUTO;
+        /** the maximum speed the robot can turn at. Value between 0-127. 127 by default */
+        int maxSpeed = 127;
+        /** the minimum speed the robot can turn at. If set to a non-zero value, the exit conditions will switch to
+         * less accurate but much faster alternatives. Value between 0-127. 0 by default */
+        int minSpeed = 0;
+        /** angle between the robot and target point where the movement will exit. Only has an effect if minSpeed is
+         * non-zero.*/
+        float earlyExitRange = 0;
+        /** whether to follow a time-optimal motion profile, with PID only correcting the residual. true by default */
+        bool profiled = true;
+};
+
+/**
+ * @brief Parameters for Chassis::swingToHeading
+ *
+ * Same as lemlib::SwingToHeadingParams, with the option to disable the motion profile
+ */
+struct SwingToHeadingParams {
+        /** the direction the robot should turn in. AUTO by default */
+        lemlib::AngularDirection direction = lemlib::AngularDirection::AUTO;
+        /** the maximum speed the robot can turn at. Value between 0-127. 127 by default */
+        float maxSpeed = 127;
+        /** the minimum speed the robot can turn at. If set to a non-zero value, the exit conditions will switch to
+         * less accurate but much faster alternatives. Value between 0-127. 0 by default */
+        float minSpeed = 0;
+        /** angle between the robot and target heading where the movement will exit. Only has an effect if minSpeed is
+         * non-zero.*/
+        float earlyExitRange = 0;
+        /** whether to follow a time-optimal motion profile, with PID only correcting the residual. true by default */
+        bool profiled = true;
+};
+
+/**
+ * @brief Parameters for traction control during driver control
+ */
+class TractionSettings {
+    public:
+        /**
+         * @brief Create a new TractionSettings object
+         *
+         * @param slipSpeed how much faster a side's wheels can turn than the ground under it moves before that side
+         * is slipping, in inches per second
+         * @param backoff fraction of the output taken off a slipping side every update, from 0 to 1
+         * @param recovery fraction of the output given back every update once the side grips again, from 0 to 1
+         * @param minOutput smallest fraction of the output a slipping side is cut to, so the robot can still push
+         *
+         * @b Example
+         * @code {.cpp}
+         * // a side slips when its wheels outrun the ground by 8 in/s. Cut it 10% per update, down to half output,
+         * // and give back 5% per update once it grips
+         * atlas::TractionSettings traction(8, 0.1, 0.05, 0.5);
+         * @endcode
+         */
+        TractionSettings(float slipSpeed, float backoff, float recovery, float minOutput)
+            : slipSpeed(slipSpeed),
+              backoff(backoff),
+              recovery(recovery),
+              minOutput(minOutput) {}
+
+        float slipSpeed;
+        float backoff;
+        float recovery;
+        float minOutput;
+};
+
+/**
+ * @brief Chassis class with the motion algorithms used by our robot
+ *
+ * This inherits from lemlib::Chassis so the drivetrain, PIDs and motion queue are shared with LemLib. Motions that
+ * are redefined here hide the LemLib versions, so calling them on an atlas::Chassis uses the versions below.
+ *
+ * Odometry runs in atlas instead of LemLib, so the pose can be filtered. The filtered pose is copied into LemLib every
+ * update, so LemLib motions that aren't redefined here still work.
+ */
+class Chassis : public lemlib::Chassis {
+    public:
+        /**
+         * @brief Construct a new Chassis
+         *
+         * @param drivetrain drivetrain to be used for the chassis
+         * @param linearSettings settings for the linear controller
+         * @param angularSettings settings for the angular controller
+         * @param lateralSettle settings for the lateral settle exit condition
+         * @param angularSettle settings for the angular settle exit condition
+         * @param lateralProfile settings for the lateral motion profile
+         * @param angularProfile settings for the angular motion profile
+         * @param sensors sensors to be used for odometry
+         * @param throttleCurve curve applied to throttle input during driver control
+         * @param steerCurve curve applied to steer input during driver control
+         */
+        Chassis(lemlib::Drivetrain drivetrain, lemlib::ControllerSettings linearSettings,
+                lemlib::ControllerSettings angularSettings, SettleSettings lateralSettle, SettleSettings angularSettle,
+                ProfileSettings lateralProfile, ProfileSettings angularProfile, OdomSensors sensors,
+                const LookupDriveCurve* throttleCurve = &defaultDriveCurve,
+                const LookupDriveCurve* steerCurve = &defaultDriveCurve);
+        /**
+         * @brief Calibrate the chassis sensors and start odometry. This should be called in the initialize function
+         *
+         * Same as lemlib::Chassis::calibrate, but starts atlas odometry instead of LemLib odometry. IMU calibration
+         * takes a few seconds, so it can run in the background while the robot does other setup.
+         *
+         * @param calibrateIMU whether the IMU should be calibrated. true by default
+         * @param async whether the function should be run asynchronously. false by default
+         * @return Calibration handle to wait on the calibration. Already done if async is false
+         *
+         * @b Example
+         * @code {.cpp}
+         * void initialize() {
+         *     // set up the screen while the IMU calibrates
+         *     atlas::Calibration calibration = chassis.calibrate(true, true);
+         *     display_img_from_c_array();
+         *     // motions need odometry, so don't leave initialize until it is running
+         *     calibration.waitUntilDone();
+         * }
+         * @endcode
+         */
+        Calibration calibrate(bool calibrateIMU = true, bool async = false);
+        /**
+         * @brief Set the pose of the chassis
+         *
+         * @param x new x value
+         * @param y new y value
+         * @param theta new theta value
+         * @param radians true if theta is in radians, false if not. False by default
+         */
+        void setPose(float x, float y, float theta, bool radians = false);
+        /**
+         * @brief Set the pose of the chassis
+         *
+         * @param pose the new pose
+         * @param radians whether pose theta is in radians (true) or not (false). false by default
+         */
+        void setPose(lemlib::Pose pose, bool radians = false);
+        /**
+         * @brief Turn the chassis so it is facing the target heading
+         *
+         * Same as lemlib::Chassis::turnToHeading, but follows a trapezoidal angular profile derived from the
+         * drivetrain, with PID only correcting the residual. Also exits as soon as the robot has settled
+         *
+         * @param theta heading location
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // turn to face 315 degrees, without a motion profile
+         * chassis.turnToHeading(315, 2000, {.profiled = false});
+         * @endcode
+         */
+        void turnToHeading(float theta, int timeout, TurnToHeadingParams params = {}, bool async = true);
+        /**
+         * @brief Turn the chassis so it is facing the target heading, but only by moving one half of the drivetrain
+         *
+         * Same as lemlib::Chassis::swingToHeading, but follows a trapezoidal angular profile derived from the
+         * drivetrain, with PID only correcting the residual. Also exits as soon as the robot has settled
+         *
+         * @param theta heading location
+         * @param lockedSide side of the drivetrain that is locked
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         */
+        void swingToHeading(float theta, lemlib::DriveSide lockedSide, int timeout, SwingToHeadingParams params = {},
+                            bool async = true);
+        /**
+         * @brief Turn the chassis so it is facing the target point
+         *
+         * Same as lemlib::Chassis::turnToPoint, but follows the same profiled turn as turnToHeading, and drives the
+         * motors through Chassis, so voltage compensation applies
+         *
+         * @param x x location
+         * @param y y location
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         */
+        void turnToPoint(float x, float y, int timeout, lemlib::TurnToPointParams params = {}, bool async = true);
+        /**
+         * @brief Turn the chassis so it is facing the target point, but only by moving one half of the drivetrain
+         *
+         * Same as lemlib::Chassis::swingToPoint, but follows the same profiled turn as swingToHeading, and drives the
+         * motors through Chassis, so voltage compensation applies. The robot moves while swinging, so the heading to
+         * the point is worked out again every update
+         *
+         * @param x x location
+         * @param y y location
+         * @param lockedSide side of the drivetrain that is locked
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         */
+        void swingToPoint(float x, float y, lemlib::DriveSide lockedSide, int timeout,
+                          lemlib::SwingToPointParams params = {}, bool async = true);
+        /**
+         * @brief Move the chassis towards the target pose
+         *
+         * Same as lemlib::Chassis::moveToPose, but also exits as soon as the robot has settled
+         *
+         * @param x x location
+         * @param y y location
+         * @param theta target heading in degrees.
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         */
+        void moveToPose(float x, float y, float theta, int timeout, lemlib::MoveToPoseParams params = {},
+                        bool async = true);
+        /**
+         * @brief Move the chassis towards a target point
+         *
+         * Same as lemlib::Chassis::moveToPoint, but also exits as soon as the robot has settled
+         *
+         * @param x x location
+         * @param y y location
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         */
+        void moveToPoint(float x, float y, int timeout, lemlib::MoveToPointParams params = {}, bool async = true);
+        /**
+         * @brief Move the chassis along a path
+         *
+         * @param path the path asset to follow
+         * @param lookahead the lookahead distance. Units in inches. Larger values will make the robot move
+         * faster but will follow the path less accurately
+         * @param timeout the maximum time the robot can spend moving
+         * @param forwards whether the robot should follow the path going forwards. true by default
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // track the path as a trajectory with a Ramsete controller
+         * chassis.follow(leftsecond_txt, 15, 5000, true, {.tracker = atlas::Tracker::RAMSETE});
+         * // pure pursuit, with the lookahead adapting between 8 and 20 inches
+         * chassis.follow(leftsecond_txt, 15, 5000, true, {.minLookahead = 8, .maxLookahead = 20});
+         * @endcode
+         */
+        void follow(const asset& path, float lookahead, int timeout, bool forwards = true, FollowParams params = {},
+                    bool async = true);
+        /**
+         * @brief Move the chassis along several paths as if they were one continuous path
+         *
+         * The lookahead point flows across the joints between segments, and the robot does not slow down at them: the
+         * ramps path.jerryio adds down to the end and up from the start of each segment are raised to the slower of
+         * the two top speeds. Only the last segment before a stop keeps its ramp down.
+         * The robot only stops between segments if the direction changes.
+         *
+         * @param segments the path segments to follow, in order
+         * @param lookahead the lookahead distance. Units in inches. Larger values will make the robot move
+         * faster but will follow the path less accurately
+         * @param timeout the maximum time the robot can spend moving, for all segments
+         * @param params struct to simulate named parameters
+         * @param async whether the function should be run asynchronously. true by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // follow two paths without stopping in between, capping the second at 80 power
+         * chassis.follow({{leftfirst_txt}, {leftsecond_txt, true, 80}}, 15, 8000);
+         * @endcode
+         */
+        void follow(std::vector<PathSegment> segments, float lookahead, int timeout, FollowParams params = {},
+                    bool async = true);
+        /**
+         * @brief Control the robot during the driver using the tank drive control scheme
+         *
+         * Same as lemlib::Chassis::tank, but the drive curve is a lookup table instead of a virtual call
+         *
+         * @param left speed of the left side of the drivetrain. Takes an input from -127 to 127.
+         * @param right speed of the right side of the drivetrain. Takes an input from -127 to 127.
+         * @param disableDriveCurve whether to disable the drive curve or not. false by default
+         */
+        void tank(int left, int right, bool disableDriveCurve = false);
+        /**
+         * @brief Control the robot during the driver using the arcade drive control scheme
+         *
+         * Same as lemlib::Chassis::arcade, but the drive curves are lookup tables instead of virtual calls
+         *
+         * @param throttle speed to move forward or backward. Takes an input from -127 to 127.
+         * @param turn speed to turn. Takes an input from -127 to 127.
+         * @param disableDriveCurve whether to disable the drive curve or not. false by default
+         * @param desaturateBias how much to favor angular motion over lateral motion or vice versa when motors are
+         * saturated. A value of 0 fully prioritizes lateral motion, a value of 1 fully prioritizes angular motion.
+         * 0.5 by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * chassis.arcade(master.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y),
+         *                master.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_X), false, 0.65);
+         * @endcode
+         */
+        void arcade(int throttle, int turn, bool disableDriveCurve = false, float desaturateBias = 0.5);
+        /**
+         * @brief Control the robot during the driver using the curvature drive control scheme
+         *
+         * Same as lemlib::Chassis::curvature, but the drive curve is a lookup table instead of a virtual call
+         *
+         * @param throttle speed to move forward or backward. Takes an input from -127 to 127.
+         * @param turn speed to turn. Takes an input from -127 to 127.
+         * @param disableDriveCurve whether to disable the drive curve or not. false by default
+         */
+        void curvature(int throttle, int turn, bool disableDriveCurve = false);
+        /**
+         * @brief Turn traction control on or off for tank, arcade and curvature
+         *
+         * The speed of each side over the ground is tracked from the IMU: the forward acceleration is integrated, and
+         * the turn rate splits it between the sides. While a side grips, the estimate follows its wheels, so it
+         * doesn't drift. When a side's wheels outrun the ground, like when spinning out on a push, its output is backed
+         * off until they catch up, so the robot keeps the traction it has. Needs an IMU with its y axis pointing
+         * forward.
+         *
+         * @param settings traction control settings, or std::nullopt to turn it off. Off by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * chassis.setTractionControl(atlas::TractionSettings(8, 0.1, 0.05, 0.5));
+         * @endcode
+         */
+        void setTractionControl(std::optional<TractionSettings> settings);
+        /**
+         * @brief Turn battery voltage compensation on or off for every motion and driver control
+         *
+         * Motor power from -127 to 127 is a fraction of what the battery gives, so the same power drives slower as the
+         * battery drains, and gains tuned on a full battery undershoot at the end of a match. With compensation on,
+         * power is scaled by how far the battery has sagged from the voltage it was tuned at and sent as a voltage,
+         * so the same power gives the same speed until the motors run out of headroom. This covers every motion
+         * defined in atlas::Chassis and driver control. LemLib motions that aren't redefined here aren't compensated.
+         *
+         * A PowerManager on the same drivetrain lowers the current limit as the battery sags, which clips the
+         * compensation, so tell it with PowerManager::setVoltageCompensated.
+         *
+         * @param nominalVoltage battery voltage the motions were tuned at, in mV, or std::nullopt to turn it off.
+         * Off by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // the PIDs were tuned on a battery at 12.6V
+         * chassis.setVoltageCompensation(12600);
+         * @endcode
+         */
+        void setVoltageCompensation(std::optional<float> nominalVoltage);
+        /**
+         * @brief Turn heading hold on or off for arcade and curvature
+         *
+         * While the robot drives with the turn stick inside the steer curve deadband, the heading it had when the
+         * stick was centered is held with its own PID, so stick noise and bumps don't make it drift. The heading is
+         * taken once the robot stops turning from the last turn, so it doesn't swing back. Any turn input lets go.
+         *
+         * The hold has its own gains, since correcting small errors while the driver is at full speed needs different
+         * gains than turning to a heading in autonomous.
+         *
+         * @param pid controller that holds the heading, with error in degrees and output from -127 to 127, or
+         * std::nullopt to turn it off. Off by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // hold the heading with kP 3 and kD 15
+         * chassis.setHeadingHold(lemlib::PID(3, 0, 15));
+         * @endcode
+         */
+        void setHeadingHold(std::optional<lemlib::PID> pid);
+    protected:
+        /**
+         * @brief Calibrate the sensors and start odometry. Shared implementation of calibrate
+         *
+         * @param calibrateIMU whether the IMU should be calibrated
+         */
+        void calibrateSensors(bool calibrateIMU);
+        /**
+         * @brief Drive each side during driver control. Shared output of tank, arcade and curvature
+         *
+         * @param left power of the left side, from -127 to 127
+         * @param right power of the right side, from -127 to 127
+         */
+        void driveSides(float left, float right);
+        /**
+         * @brief Back off the output of sides that are slipping
+         *
+         * @param left power of the left side, scaled down if it slips
+         * @param right power of the right side, scaled down if it slips
+         */
+        void tractionControl(float& left, float& right);
+        /**
+         * @brief Move a side of the drivetrain, compensating for the battery if it is turned on. Every Chassis motion
+         * drives the motors through this
+         *
+         * @param motors the motors to move
+         * @param power power from -127 to 127
+         */
+        void moveMotors(pros::MotorGroup* motors, float power);
+        /**
+         * @brief Work out the turn that holds the heading during driver control
+         *
+         * @param throttle throttle input, from -127 to 127
+         * @param turn turn input, from -127 to 127
+         * @return std::optional<float> the turn power that holds the heading, or std::nullopt if it isn't held
+         */
+        std::optional<float> holdHeading(int throttle, int turn);
+        /**
+         * @brief Turn or swing to a heading or point. Shared implementation of the turn and swing motions
+         *
+         * @param theta heading location. The heading to the point at the start, when turning to a point
+         * @param lockedSide side of the drivetrain that is locked, or std::nullopt to turn in place
+         * @param timeout longest time the robot can spend moving
+         * @param params struct to simulate named parameters
+         * @param point point to face, whose heading is worked out again every update. std::nullopt by default
+         * @param forwards whether the front of the robot faces the point, rather than the back. true by default
+         */
+        void headingMotion(float theta, std::optional<lemlib::DriveSide> lockedSide, int timeout,
+                           SwingToHeadingParams params, std::optional<lemlib::Pose> point = std::nullopt,
+                           bool forwards = true);
+        /**
+         * @brief Follow a run of a path with pure pursuit, until the end of the run
+         *
+         * @param run the run to follow
+         * @param lookahead the lookahead distance, in inches. Used when the lookahead isn't adaptive
+         * @param params adaptive lookahead settings
+         * @param timer timer of the whole motion
+         */
+        void pursueRun(const PathRun& run, float lookahead, const FollowParams& params, lemlib::Timer& timer);
+        /**
+         * @brief Follow a run of a path with a Ramsete controller, until the end of the run
+         *
+         * @param run the run to follow
+         * @param params Ramsete gains
+         * @param timer timer of the whole motion
+         */
+        void ramseteRun(const PathRun& run, const FollowParams& params, lemlib::Timer& timer);
+
+        OdomSensors odomSensors;
+        SettleExitCondition lateralSettleExit;
+        SettleExitCondition angularSettleExit;
+        ProfileSettings lateralProfile;
+        ProfileSettings angularProfile;
+        const LookupDriveCurve* throttleLookup;
+        const LookupDriveCurve* steerLookup;
+        std::optional<TractionSettings> traction;
+        float groundSpeed = 0; // forward speed of the robot over the ground, in inches per second
+        float leftTraction = 1; // fraction of the output each side gets
+        float rightTraction = 1;
+        std::uint32_t tractionTime = 0; // last traction control update, in ms
+        std::optional<float> nominalVoltage;
+        float batteryVoltage = 0; // filtered battery voltage, in mV. 0 until it is first read
+        std::optional<lemlib::PID> headingPID; // holds the heading, std::nullopt when heading hold is off
+        bool holding = false; // whether the heading is being held right now
+        float holdTarget = 0; // the heading being held, in degrees
+};
+} // namespace atlas
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "atlas/chassis/chassis.hpp"
+#include "lemlib/pose.hpp"
+
+namespace atlas {
+/**
+ * @brief How odometry integrates the motion measured in each update
+ */
+enum class Integration {
+    ARC, /** constant curvature arc, like LemLib. Exact when the speed and turn rate are constant over an update */
+    MAGNUS /** arc with a second order correction for the speed and turn rate changing within an update */
+};
+
+/**
+ * @brief Set the sensors to be used for odometry
+ *
+ * While odometry is running, the sensors are switched by the odometry task between updates, and this waits until
+ * they are, so recalibrating is safe.
+ *
+ * @param sensors the sensors to be used
+ * @param drivetrain drivetrain to be used
+ */
+void setSensors(OdomSensors sensors, lemlib::Drivetrain drivetrain);
+/**
+ * @brief Get the pose of the robot
+ *
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return lemlib::Pose
+ */
+lemlib::Pose getPose(bool radians = false);
+/**
+ * @brief Set the pose of the robot
+ *
+ * The pose is treated as exact, so the filter trusts it until the robot moves. While odometry is running, the pose
+ * is applied by the odometry task on its next update, and this waits until it is, so it is safe to call from any
+ * task.
+ *
+ * @param pose the new pose
+ * @param radians true if theta is in radians, false if in degrees. False by default
+ */
+void setPose(lemlib::Pose pose, bool radians = false);
+/**
+ * @brief Correct the pose of the robot with an external estimate
+ *
+ * The estimate is fused by the odometry task on its next update, weighted by its variance. This is safe to call from
+ * any task while odometry is running, and doesn't wait for the update.
+ *
+ * @param pose the estimated pose, theta in radians
+ * @param variance how uncertain the estimate is, in in^2 for x and y and rad^2 for theta
+ */
+void correctPose(lemlib::Pose pose, lemlib::Pose variance);
+/**
+ * @brief Get the pose measured by the tracking wheels and IMU alone
+ *
+ * This is never corrected, so it drifts, but it only ever changes by the motion of the robot. The difference between
+ * two readings is how far the robot moved.
+ *
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return lemlib::Pose
+ */
+lemlib::Pose getOdomPose(bool radians = false);
+/**
+ * @brief Get the speed of the robot
+ *
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return lemlib::Pose
+ */
+lemlib::Pose getSpeed(bool radians = false);
+/**
+ * @brief Get the local speed of the robot
+ *
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return lemlib::Pose
+ */
+lemlib::Pose getLocalSpeed(bool radians = false);
+/**
+ * @brief Set how odometry integrates motion
+ *
+ * MAGNUS estimates how the motion changes within each update from the previous update, so it stays accurate when
+ * the robot accelerates hard while turning. ARC by default.
+ *
+ * @param integration the integration method
+ */
+void setIntegration(Integration integration);
+/**
+ * @brief Update the pose of the robot
+ *
+ * Integrates the tracking wheels and IMU like LemLib odometry, then fuses the result with the GPS and the distance
+ * sensors in an extended Kalman filter. The fused pose is written back to LemLib, so lemlib::getPose and the LemLib
+ * motions see it too.
+ */
+void update();
+/**
+ * @brief Initialize the odometry system
+ *
+ */
+void init();
+} // namespace atlas
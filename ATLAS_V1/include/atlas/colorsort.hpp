@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "pros/optical.hpp"
+#include "pros/rtos.hpp"
+#include "atlas/actuator.hpp"
+#include "atlas/intake.hpp"
+
+namespace atlas {
+/**
+ * @brief Color of a game element
+ */
+enum class GameColor { NONE, RED, BLUE };
+
+/**
+ * @brief Parameters for color sorting
+ */
+class ColorSortSettings {
+    public:
+        /**
+         * @brief Create a new ColorSortSettings object
+         *
+         * @param distance how far a game element travels from the optical sensor to the redirect, in inches
+         * @param rollerDiameter diameter of the intake roller carrying the game elements past the sensor, in inches
+         * @param ejectTime how long the redirect stays switched to throw out an element, in ms
+         * @param minProximity proximity reading above which a game element is in front of the sensor, out of 255
+         *
+         * @b Example
+         * @code {.cpp}
+         * // elements travel 8 inches on a 2 inch roller to the redirect, which switches for 200ms to throw them out
+         * atlas::ColorSortSettings sortSettings(8, 2, 200, 100);
+         * @endcode
+         */
+        ColorSortSettings(float distance, float rollerDiameter, float ejectTime, float minProximity)
+            : distance(distance),
+              rollerDiameter(rollerDiameter),
+              ejectTime(ejectTime),
+              minProximity(minProximity) {}
+
+        float distance;
+        float rollerDiameter;
+        float ejectTime;
+        float minProximity;
+};
+
+/**
+ * @brief Throws out game elements of the wrong color, in a background task
+ *
+ * The optical sensor is read as often as it measures. Hue is classified with hysteresis, so an element sitting on the
+ * edge of a color band doesn't flicker between colors and get thrown out twice. When an element of the rejected color
+ * arrives, the time it takes to reach the redirect is worked out from how fast the intake is moving, and the redirect
+ * is switched at that moment, then switched back. The driver loop never waits on any of it.
+ */
+class ColorSort {
+    public:
+        /**
+         * @brief Create a new ColorSort
+         *
+         * @param sensor the optical sensor the game elements pass
+         * @param redirect the piston that throws out game elements
+         * @param intake the intake carrying the game elements from the sensor to the redirect. Elements only reach the
+         * redirect while it turns forwards, so nothing is ejected while it runs backwards or clears a jam
+         * @param settings color sort settings
+         */
+        ColorSort(pros::Optical* sensor, CachedPneumatics* redirect, Intake* intake, ColorSortSettings settings);
+        /**
+         * @brief Set the color to throw out
+         *
+         * @param color the color to throw out. GameColor::NONE to stop sorting
+         */
+        void reject(GameColor color);
+        /**
+         * @brief Get the color of the game element in front of the sensor
+         */
+        GameColor getColor() const;
+        /**
+         * @brief Extend or retract the redirect
+         *
+         * Once sorting starts, only the sort task commands the redirect, so driver control goes through here instead
+         * of the piston. An eject switches the redirect away from this position and back to it, so changing it
+         * during an eject isn't undone.
+         *
+         * @param extended true to extend, false to retract
+         */
+        void setRedirect(bool extended);
+        /**
+         * @brief Switch the redirect to the other position
+         */
+        void toggleRedirect();
+        /**
+         * @brief Start sorting in a task
+         */
+        void start();
+    private:
+        /**
+         * @brief Read the sensor and classify the game element in front of it
+         *
+         * @return GameColor the color, with hysteresis from the last color
+         */
+        GameColor classify();
+        /**
+         * @brief Schedule throwing out the game element that just passed the sensor
+         *
+         * @param now the current time, in ms
+         */
+        void schedule(std::uint32_t now);
+
+        pros::Optical* sensor;
+        CachedPneumatics* redirect;
+        Intake* intake;
+        ColorSortSettings settings;
+        std::atomic<GameColor> rejected = GameColor::NONE;
+        std::atomic<GameColor> color = GameColor::NONE;
+        std::uint32_t ejectStart = 0; // when the redirect switches, 0 if nothing is scheduled
+        std::uint32_t ejectEnd = 0; // when the redirect switches back
+        bool switched = false;
+        std::atomic<bool> redirectExtended; // where the redirect is when it isn't ejecting
+        pros::Task* task = nullptr;
+};
+} // namespace atlas
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "pros/misc.hpp"
+
+namespace atlas {
+/** how often the controller sends the brain new data, in ms */
+constexpr std::uint32_t CONTROLLER_PERIOD = 10;
+
+/**
+ * @brief Every axis and button of the controller, read at the same moment
+ *
+ * Buttons are stored as bits, in the order of pros::controller_digital_e_t starting at L1.
+ */
+struct ControllerState {
+        int leftX = 0;
+        int leftY = 0;
+        int rightX = 0;
+        int rightY = 0;
+        /** buttons being held */
+        std::uint16_t buttons = 0;
+        /** buttons that were pressed since the last read */
+        std::uint16_t pressed = 0;
+        /** buttons that were released since the last read */
+        std::uint16_t released = 0;
+
+        /**
+         * @brief Get the bit of a button
+         *
+         * @param button the button
+         * @return std::uint16_t the bit the button is stored in
+         */
+        static constexpr std::uint16_t bit(pros::controller_digital_e_t button) {
+            return 1 << (button - pros::E_CONTROLLER_DIGITAL_L1);
+        }
+
+        /**
+         * @brief Check if a button is being held
+         */
+        bool held(pros::controller_digital_e_t button) const { return buttons & bit(button); }
+
+        /**
+         * @brief Check if a button was pressed since the last read
+         */
+        bool newPress(pros::controller_digital_e_t button) const { return pressed & bit(button); }
+
+        /**
+         * @brief Check if a button was released since the last read
+         */
+        bool newRelease(pros::controller_digital_e_t button) const { return released & bit(button); }
+};
+
+/**
+ * @brief Reads the controller once per update, in step with the controller
+ *
+ * pros::delay in a driver loop drifts by however long the loop takes, so it slides in and out of step with the
+ * controller and the time from the stick moving to the motors moving jumps around. ControllerInput waits with
+ * delay_until at the rate the controller sends data, so every update sees new data at the same delay, and reads
+ * every axis and button in one snapshot so the whole update acts on the same input.
+ *
+ * @b Example
+ * @code {.cpp}
+ * void opcontrol() {
+ *     atlas::ControllerInput input(&master);
+ *     while (true) {
+ *         const atlas::ControllerState& state = input.read();
+ *         chassis.arcade(state.leftY, state.rightX);
+ *         if (state.newPress(pros::E_CONTROLLER_DIGITAL_B)) redirect.toggle();
+ *         input.wait();
+ *     }
+ * }
+ * @endcode
+ */
+class ControllerInput {
+    public:
+        /**
+         * @brief Create a new ControllerInput
+         *
+         * @param controller the controller to read
+         */
+        ControllerInput(pros::Controller* controller);
+        /**
+         * @brief Read every axis and button
+         *
+         * @return const ControllerState& the snapshot, valid until the next read
+         */
+        const ControllerState& read();
+        /**
+         * @brief Wait until the next update
+         *
+         * Updates are a fixed period apart, no matter how long the loop took.
+         */
+        void wait();
+    private:
+        pros::Controller* controller;
+        ControllerState state;
+        std::uint32_t time = 0;
+};
+
+/**
+ * @brief How a binding reacts to its button
+ */
+enum class Trigger {
+    PRESS, /** run the action with the value once, when the button is pressed */
+    TOGGLE, /** switch between the value and 0 every press */
+    HOLD /** the value while the button is held, and 0 once it is released */
+};
+
+/**
+ * @brief A button bound to an action
+ */
+struct Binding {
+        /** the button that triggers the action */
+        pros::controller_digital_e_t button;
+        /** how the action is triggered */
+        Trigger trigger;
+        /** the action, called with the value */
+        void (*action)(int value);
+        /** value passed to the action. 1 by default */
+        int value = 1;
+};
+
+/**
+ * @brief Runs actions bound to buttons, only when their output changes
+ *
+ * HOLD bindings that share an action are checked in the order they were given, so the first one held sets the value,
+ * like an if/else ladder. The action is only called when that value changes, so holding a button or leaving every
+ * button alone doesn't send the same command every update. The first update always calls every HOLD action, so the
+ * mechanisms start in a known state.
+ *
+ * @b Example
+ * @code {.cpp}
+ * atlas::ButtonBindings bindings({
+ *     {pros::E_CONTROLLER_DIGITAL_R1, atlas::Trigger::HOLD, stage1, 127},
+ *     {pros::E_CONTROLLER_DIGITAL_L1, atlas::Trigger::HOLD, stage1, -127},
+ *     {pros::E_CONTROLLER_DIGITAL_B, atlas::Trigger::PRESS, [](int) { redirect.toggle(); }},
+ * });
+ * while (true) {
+ *     bindings.update(input.read());
+ *     input.wait();
+ * }
+ * @endcode
+ */
+class ButtonBindings {
+    public:
+        /**
+         * @brief Create a new ButtonBindings
+         *
+         * @param bindings the bindings, in priority order
+         */
+        ButtonBindings(std::vector<Binding> bindings);
+        /**
+         * @brief Run the actions triggered by a controller snapshot
+         *
+         * @param state the controller snapshot
+         */
+        void update(const ControllerState& state);
+    private:
+        std::vector<Binding> bindings;
+        std::vector<bool> toggled; // state of each TOGGLE binding
+        std::vector<std::optional<int>> outputs; // last value sent by the first HOLD binding of each action
+};
+} // namespace atlas
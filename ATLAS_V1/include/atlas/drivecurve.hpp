@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+namespace atlas {
+/**
+ * @brief An exponential drive curve, precomputed for every joystick input
+ *
+ * Same curve as lemlib::ExpoDriveCurve, but the joystick only reports whole numbers from -127 to 127, so every output
+ * is computed once, at compile time if the curve is constexpr. Curving an input is then a single array load, with no
+ * pow and no virtual call.
+ *
+ * see https://www.desmos.com/calculator/umicbymbnl for an interactive graph
+ */
+class LookupDriveCurve {
+    public:
+        /**
+         * @brief Create a new LookupDriveCurve
+         *
+         * @param deadband range where input is considered to be input
+         * @param minOutput the minimum output that can be returned
+         * @param curve how "curved" the graph is
+         *
+         * @b Example
+         * @code {.cpp}
+         * // controller deadband is set to 3, minimum output is set to 10, curve gain is set to 1.019
+         * constexpr atlas::LookupDriveCurve throttle_curve(3, 10, 1.019);
+         * @endcode
+         */
+        constexpr LookupDriveCurve(float deadband, float minOutput, float curve) {
+            // output at full input, which the curve is scaled to
+            const float g127 = 127 - deadband;
+            const double logCurve = log(curve);
+            const float i127 = exp((g127 - 127) * logCurve) * g127;
+            for (int input = -127; input <= 127; input++) {
+                float& output = table[input + 127];
+                const int magnitude = input < 0 ? -input : input;
+                if (magnitude <= deadband) {
+                    output = 0;
+                    continue;
+                }
+                const float sign = input > 0 ? 1 : -1;
+                const float g = magnitude - deadband;
+                const float i = exp((g - 127) * logCurve) * g * sign;
+                output = (127 - minOutput) / 127 * i * 127 / i127 + minOutput * sign;
+            }
+        }
+
+        /**
+         * @brief Curve an input
+         *
+         * @param input the joystick input, from -127 to 127. Larger inputs are clamped
+         * @return float the curved output
+         */
+        constexpr float curve(int input) const { return table[std::clamp(input, -127, 127) + 127]; }
+    private:
+        /**
+         * @brief Natural log that can run at compile time. std::log can't in standard C++
+         *
+         * @param x a positive number
+         */
+        static constexpr double log(double x) {
+            // ln(x) = 2 atanh((x - 1) / (x + 1)), a series that converges for every positive x
+            const double z = (x - 1) / (x + 1);
+            double power = z;
+            double sum = 0;
+            for (int n = 1; n < 1000; n += 2) {
+                const double term = power / n;
+                sum += term;
+                if (term < 1e-17 && term > -1e-17) break;
+                power *= z * z;
+            }
+            return 2 * sum;
+        }
+
+        /**
+         * @brief Exponential that can run at compile time. std::exp can't in standard C++
+         */
+        static constexpr double exp(double x) {
+            // halve x until the Taylor series converges quickly, then square the result back up
+            int halvings = 0;
+            while (x > 0.5 || x < -0.5) {
+                x /= 2;
+                halvings++;
+            }
+            double term = 1;
+            double sum = 1;
+            for (int n = 1; n < 20; n++) {
+                term *= x / n;
+                sum += term;
+            }
+            for (int i = 0; i < halvings; i++) sum *= sum;
+            return sum;
+        }
+
+        std::array<float, 255> table {};
+};
+
+/** linear curve with no deadband, used when a Chassis is created without curves */
+inline constexpr LookupDriveCurve defaultDriveCurve(0, 0, 1);
+} // namespace atlas
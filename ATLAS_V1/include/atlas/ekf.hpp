@@ -0,0 +1,90 @@
+#pragma once
+
+#include "lemlib/pose.hpp"
+#include "atlas/matrix.hpp"
+
+namespace atlas {
+/**
+ * @brief Extended Kalman filter estimating the pose of the robot
+ *
+ * The state is [x, y, theta], in inches and radians, with theta using the same convention as LemLib odometry (0 is
+ * facing +y, clockwise is positive, not wrapped). The filter is predicted with the motion measured by the tracking
+ * wheels and IMU every odometry update, and corrected whenever an absolute measurement of the pose is available, like
+ * the GPS.
+ *
+ * All the math uses fixed-size matrices, so nothing is allocated while the filter runs.
+ */
+class Ekf {
+    public:
+        /**
+         * @brief Create a new Ekf
+         *
+         * @param translationNoise variance added per inch the robot travels, in in^2/in
+         * @param rotationNoise variance added per radian the robot turns, in rad^2/rad
+         * @param driftNoise heading variance added every update, in rad^2
+         */
+        Ekf(float translationNoise, float rotationNoise, float driftNoise);
+        /**
+         * @brief Reset the estimate to a known pose
+         *
+         * @param pose the pose of the robot, theta in radians
+         * @param variance how uncertain the pose is, in in^2 for x and y and rad^2 for theta
+         */
+        void reset(lemlib::Pose pose, lemlib::Pose variance = {0, 0, 0});
+        /**
+         * @brief Move the estimate by the motion measured since the last update
+         *
+         * @param localX distance traveled to the right of the robot over the update, in inches
+         * @param localY distance traveled forwards over the update, in inches
+         * @param deltaTheta change in heading over the update, in radians
+         * @param slipVariance extra position variance for this update, when the motion is known to be unreliable, in
+         * in^2. 0 by default
+         */
+        void predict(float localX, float localY, float deltaTheta, float slipVariance = 0);
+        /**
+         * @brief Correct the estimate with a measurement
+         *
+         * The measurement is rejected if its Mahalanobis distance from the estimate is larger than the gate, so a
+         * single bad reading can't throw the pose off.
+         *
+         * @tparam M number of values in the measurement
+         * @param innovation the measurement minus the measurement predicted from the current estimate
+         * @param H jacobian of the measurement with respect to the state
+         * @param R covariance of the measurement noise
+         * @param gate largest squared Mahalanobis distance a measurement can have and still be used
+         * @return true the measurement was used
+         * @return false the measurement was rejected
+         */
+        template <int M>
+        bool correct(const Matrix<M, 1>& innovation, const Matrix<M, 3>& H, const Matrix<M, M>& R, float gate) {
+            const Matrix<3, M> Ht = H.transpose();
+            const Matrix<M, M> S = H * P * Ht + R;
+            Matrix<M, M> Sinv;
+            if (!S.inverse(Sinv)) return false;
+            // reject outliers
+            if ((innovation.transpose() * Sinv * innovation)(0, 0) > gate) return false;
+            const Matrix<3, M> K = P * Ht * Sinv;
+            x = x + K * innovation;
+            P = (Matrix<3, 3>::identity() - K * H) * P;
+            return true;
+        }
+        /**
+         * @brief Get the estimated pose
+         *
+         * @return lemlib::Pose the pose of the robot, theta in radians
+         */
+        lemlib::Pose getPose() const;
+        /**
+         * @brief Get the covariance of the estimate
+         *
+         * @return const Matrix<3, 3>& the covariance, in inches and radians
+         */
+        const Matrix<3, 3>& getCovariance() const;
+    private:
+        float translationNoise;
+        float rotationNoise;
+        float driftNoise;
+        Matrix<3, 1> x;
+        Matrix<3, 3> P;
+};
+} // namespace atlas
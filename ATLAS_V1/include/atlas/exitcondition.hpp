@@ -0,0 +1,93 @@
+#pragma once
+
+#include "lemlib/exitcondition.hpp"
+
+namespace atlas {
+/**
+ * @brief Settings for a velocity-aware exit condition
+ *
+ * The robot is considered settled once the error is inside the range, the measured speed and acceleration are
+ * both small, and the error predicted after the robot brakes to a stop is still inside the range. The settled
+ * state has to hold for a short dwell time before the motion exits.
+ */
+class SettleSettings {
+    public:
+        /**
+         * @brief Create a new SettleSettings object
+         *
+         * @param range error range where the robot may be considered settled
+         * @param time how long the robot has to stay settled before exiting, in milliseconds
+         * @param maxSpeed maximum speed where the robot is considered stationary
+         * @param maxAccel maximum acceleration where the robot is considered stationary. Also used as the braking
+         * deceleration when predicting where the robot will come to rest
+         *
+         * @b Example
+         * @code {.cpp}
+         * // lateral settle settings
+         * atlas::SettleSettings lateralSettle(1, // error range, in inches
+         *                                     30, // dwell time, in milliseconds
+         *                                     2, // max speed, in inches per second
+         *                                     40 // max acceleration, in inches per second squared
+         * );
+         * @endcode
+         */
+        SettleSettings(float range, float time, float maxSpeed, float maxAccel)
+            : range(range),
+              time(time),
+              maxSpeed(maxSpeed),
+              maxAccel(maxAccel) {}
+
+        float range;
+        float time;
+        float maxSpeed;
+        float maxAccel;
+};
+
+/**
+ * @brief Exit condition that also considers velocity, acceleration and the error derivative
+ *
+ * lemlib::ExitCondition only checks that the error stays inside a range for a set amount of time, so every motion
+ * waits out the full timeout even when the robot has clearly stopped. This exit condition exits as soon as the robot
+ * is provably stationary within tolerance.
+ */
+class SettleExitCondition : public lemlib::ExitCondition {
+    public:
+        /**
+         * @brief Create a new SettleExitCondition
+         *
+         * @param settings the settle settings to use
+         */
+        SettleExitCondition(const SettleSettings& settings);
+        /**
+         * @brief update the exit condition
+         *
+         * @param error the current error
+         * @param speed the current measured speed, in the same units as the error per second
+         * @return true exit condition met
+         * @return false exit condition not met
+         *
+         * @b Example
+         * @code {.cpp}
+         * while (!ec.getExit()) {
+         *     const lemlib::Pose speed = lemlib::getLocalSpeed();
+         *     ec.update(error, std::hypot(speed.x, speed.y));
+         *     pros::delay(10);
+         * }
+         * @endcode
+         */
+        bool update(const float error, const float speed);
+        /**
+         * @brief reset the exit condition
+         */
+        void reset();
+    protected:
+        const float maxSpeed;
+        const float maxAccel;
+
+        float prevError = 0;
+        float prevSpeed = 0;
+        float errorRate = 0;
+        float accel = 0;
+        int prevTime = -1;
+};
+} // namespace atlas
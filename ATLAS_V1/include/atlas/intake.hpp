@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "pros/motors.hpp"
+#include "pros/rtos.hpp"
+#include "atlas/actuator.hpp"
+
+namespace atlas {
+/**
+ * @brief How an Intake drives its motor
+ */
+enum class IntakeMode {
+    VOLTAGE, /** open loop, like pros::Motor::move */
+    VELOCITY /** the motor's velocity controller, which holds speed under load */
+};
+
+/**
+ * @brief Parameters for jam detection
+ */
+class IntakeSettings {
+    public:
+        /**
+         * @brief Create a new IntakeSettings object
+         *
+         * @param jamCurrent current above which the motor may be jammed, in mA
+         * @param jamVelocity speed below which the motor may be jammed, in rpm
+         * @param jamTime how long the motor has to look jammed before it is unjammed, in ms
+         * @param unjamTime how long the motor runs backwards to clear a jam, in ms
+         *
+         * @b Example
+         * @code {.cpp}
+         * // a blue motor drawing over 2A while turning slower than 50rpm for 150ms is jammed, so reverse for 150ms
+         * atlas::IntakeSettings intakeSettings(2000, 50, 150, 150);
+         * @endcode
+         */
+        IntakeSettings(float jamCurrent, float jamVelocity, float jamTime, float unjamTime)
+            : jamCurrent(jamCurrent),
+              jamVelocity(jamVelocity),
+              jamTime(jamTime),
+              unjamTime(unjamTime) {}
+
+        float jamCurrent;
+        float jamVelocity;
+        float jamTime;
+        float unjamTime;
+};
+
+/**
+ * @brief An intake stage that clears its own jams
+ *
+ * The motor is jammed when it draws a lot of current but barely turns, while being told to move. After jamTime of
+ * that, it runs backwards at full power for unjamTime to spit out the stuck game element, then goes back to what it
+ * was told to do.
+ *
+ * With an update task running, only the task commands the motor, so move is safe to call from any task.
+ */
+class Intake {
+    public:
+        /**
+         * @brief Create a new Intake
+         *
+         * @param motor the intake motor
+         * @param settings jam detection settings
+         * @param mode how the motor is driven. VELOCITY by default
+         */
+        Intake(pros::Motor* motor, IntakeSettings settings, IntakeMode mode = IntakeMode::VELOCITY);
+        /**
+         * @brief Move the intake
+         *
+         * @param power from -127 to 127. In velocity mode, 127 is the top speed of the gearset
+         */
+        void move(int power);
+        /**
+         * @brief Set how the motor is driven
+         */
+        void setMode(IntakeMode mode);
+        /**
+         * @brief Check if the intake is running backwards to clear a jam
+         */
+        bool isUnjamming() const;
+        /**
+         * @brief Get the intake motor, for reading its sensors
+         */
+        pros::Motor* getMotor() const;
+        /**
+         * @brief Check for jams and command the motor
+         *
+         * Called by the update task. Call it every loop if the task isn't started.
+         */
+        void update();
+        /**
+         * @brief Start updating in a task
+         *
+         * @param period time between updates, in ms. 10 by default
+         */
+        void start(std::uint32_t period = 10);
+    private:
+        CachedMotor motor;
+        IntakeSettings settings;
+        std::atomic<IntakeMode> mode;
+        std::atomic<int> power = 0;
+        std::atomic<bool> unjamming = false;
+        std::uint32_t jamStart = 0; // when the motor started looking jammed, 0 if it isn't
+        std::uint32_t unjamStart = 0;
+        pros::Task* task = nullptr;
+};
+} // namespace atlas
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <initializer_list>
+#include <utility>
+
+namespace atlas {
+/**
+ * @brief Fixed-size matrix
+ *
+ * The size is known at compile time and the elements are stored inline, so matrix math never allocates. This is all
+ * the filters in the odometry task need, without pulling in a linear algebra library.
+ *
+ * @tparam R number of rows
+ * @tparam C number of columns
+ */
+template <int R, int C> class Matrix {
+    public:
+        /**
+         * @brief Create a matrix filled with zeros
+         */
+        constexpr Matrix() : data {} {}
+
+        /**
+         * @brief Create a matrix from its elements, in row-major order
+         *
+         * Missing elements are 0. Elements past the end of the matrix are ignored
+         *
+         * @b Example
+         * @code {.cpp}
+         * atlas::Matrix<2, 2> m = {1, 2,
+         *                          3, 4};
+         * @endcode
+         */
+        constexpr Matrix(std::initializer_list<float> values) : data {} {
+            int i = 0;
+            for (float value : values) {
+                if (i == R * C) break;
+                data[i++] = value;
+            }
+        }
+
+        /**
+         * @brief Create an identity matrix
+         */
+        static constexpr Matrix identity() {
+            static_assert(R == C, "identity matrix must be square");
+            Matrix m;
+            for (int i = 0; i < R; i++) m(i, i) = 1;
+            return m;
+        }
+
+        constexpr float& operator()(int row, int col) { return data[row * C + col]; }
+
+        constexpr float operator()(int row, int col) const { return data[row * C + col]; }
+
+        constexpr Matrix operator+(const Matrix& other) const {
+            Matrix m;
+            for (int i = 0; i < R * C; i++) m.data[i] = data[i] + other.data[i];
+            return m;
+        }
+
+        constexpr Matrix operator-(const Matrix& other) const {
+            Matrix m;
+            for (int i = 0; i < R * C; i++) m.data[i] = data[i] - other.data[i];
+            return m;
+        }
+
+        constexpr Matrix operator*(float scalar) const {
+            Matrix m;
+            for (int i = 0; i < R * C; i++) m.data[i] = data[i] * scalar;
+            return m;
+        }
+
+        template <int N> constexpr Matrix<R, N> operator*(const Matrix<C, N>& other) const {
+            Matrix<R, N> m;
+            for (int i = 0; i < R; i++) {
+                for (int j = 0; j < N; j++) {
+                    float sum = 0;
+                    for (int k = 0; k < C; k++) sum += (*this)(i, k) * other(k, j);
+                    m(i, j) = sum;
+                }
+            }
+            return m;
+        }
+
+        constexpr Matrix<C, R> transpose() const {
+            Matrix<C, R> m;
+            for (int i = 0; i < R; i++) {
+                for (int j = 0; j < C; j++) m(j, i) = (*this)(i, j);
+            }
+            return m;
+        }
+
+        /**
+         * @brief Invert the matrix with Gauss-Jordan elimination
+         *
+         * @param out the inverse
+         * @return true the matrix was inverted
+         * @return false the matrix is singular, out is unchanged
+         */
+        bool inverse(Matrix& out) const {
+            static_assert(R == C, "only square matrices can be inverted");
+            Matrix a = *this;
+            Matrix inv = identity();
+            for (int col = 0; col < R; col++) {
+                // partial pivoting for numerical stability
+                int pivot = col;
+                for (int row = col + 1; row < R; row++) {
+                    if (std::fabs(a(row, col)) > std::fabs(a(pivot, col))) pivot = row;
+                }
+                if (std::fabs(a(pivot, col)) < 1e-9f) return false;
+                if (pivot != col) {
+                    for (int j = 0; j < R; j++) {
+                        std::swap(a(pivot, j), a(col, j));
+                        std::swap(inv(pivot, j), inv(col, j));
+                    }
+                }
+                const float scale = 1 / a(col, col);
+                for (int j = 0; j < R; j++) {
+                    a(col, j) *= scale;
+                    inv(col, j) *= scale;
+                }
+                for (int row = 0; row < R; row++) {
+                    if (row == col) continue;
+                    const float factor = a(row, col);
+                    for (int j = 0; j < R; j++) {
+                        a(row, j) -= factor * a(col, j);
+                        inv(row, j) -= factor * inv(col, j);
+                    }
+                }
+            }
+            out = inv;
+            return true;
+        }
+    private:
+        std::array<float, R * C> data;
+};
+} // namespace atlas
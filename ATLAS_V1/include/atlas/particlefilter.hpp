@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "pros/rtos.hpp"
+#include "lemlib/pose.hpp"
+#include "atlas/relocalize.hpp"
+
+namespace atlas {
+/** number of particles in the filter. A multiple of 4, so the vectorized loops have no remainder */
+constexpr int NUM_PARTICLES = 256;
+
+/**
+ * @brief Monte Carlo localization with the distance sensors
+ *
+ * Unlike the Kalman filter in odometry, which can only track small errors, the particle filter keeps many guesses of
+ * the pose spread over the field. Each guess is moved by the odometry, then weighted by how well it explains what the
+ * distance sensors see. Guesses that don't match are replaced by copies of ones that do. This lets it recover when
+ * the pose is badly wrong, like after setting the wrong starting pose.
+ *
+ * The particles are stored as separate arrays of x, y and theta, so the motion and measurement models vectorize with
+ * NEON on the brain. Poses are in the field frame, with the origin at the center of the field.
+ */
+class ParticleFilter {
+    public:
+        /**
+         * @brief Create a new ParticleFilter
+         *
+         * @param sensors the distance sensors to localize with
+         */
+        ParticleFilter(std::vector<DistanceSensor> sensors);
+        /**
+         * @brief Spread the particles around a pose
+         *
+         * @param pose the pose to spread around, theta in radians
+         * @param positionSpread standard deviation of the position, in inches
+         * @param headingSpread standard deviation of the heading, in radians
+         */
+        void reset(lemlib::Pose pose, float positionSpread, float headingSpread);
+        /**
+         * @brief Move the particles by the motion measured by odometry, with noise
+         *
+         * @param localX distance traveled to the right of the robot, in inches
+         * @param localY distance traveled forwards, in inches
+         * @param deltaTheta change in heading, in radians
+         */
+        void predict(float localX, float localY, float deltaTheta);
+        /**
+         * @brief Weight the particles by a distance sensor reading
+         *
+         * @param sensor index of the sensor that took the reading
+         * @param reading the measured distance, in inches
+         */
+        void weigh(int sensor, float reading);
+        /**
+         * @brief Replace unlikely particles with copies of likely ones, if the weights have become uneven
+         */
+        void resample();
+        /**
+         * @brief Get the weighted average pose of the particles
+         *
+         * @return lemlib::Pose the estimate, theta in radians
+         */
+        lemlib::Pose getEstimate() const;
+        /**
+         * @brief Get how spread out the particles are
+         *
+         * @return float weighted standard deviation of the distance of the particles from the estimate, in inches
+         */
+        float getSpread() const;
+        /**
+         * @brief Start localizing in a low priority task
+         *
+         * The particles are spread around the current odometry pose. When they agree on a pose that is far from the
+         * odometry pose, it is published to odometry with atlas::correctPose.
+         */
+        void start();
+    private:
+        /**
+         * @brief Get a random number between 0 and 1
+         */
+        float uniform();
+        /**
+         * @brief Get a random number from a standard normal distribution
+         */
+        float gaussian();
+        /**
+         * @brief Update the cached sine and cosine of each particle heading
+         */
+        void updateTrig();
+        /**
+         * @brief Get the normalized weight of each particle
+         *
+         * @param weights output for the weights, which add up to 1
+         */
+        void normalizedWeights(std::array<float, NUM_PARTICLES>& weights) const;
+
+        std::vector<DistanceSensor> sensors;
+        std::vector<float> prevReadings; // last reading weighed from each sensor, -1 before the first
+        alignas(16) std::array<float, NUM_PARTICLES> x;
+        alignas(16) std::array<float, NUM_PARTICLES> y;
+        alignas(16) std::array<float, NUM_PARTICLES> theta;
+        alignas(16) std::array<float, NUM_PARTICLES> logWeight;
+        alignas(16) std::array<float, NUM_PARTICLES> sinTheta;
+        alignas(16) std::array<float, NUM_PARTICLES> cosTheta;
+        // scratch space for noise and resampling, so nothing is allocated while the filter runs
+        alignas(16) std::array<float, NUM_PARTICLES> scratchX;
+        alignas(16) std::array<float, NUM_PARTICLES> scratchY;
+        alignas(16) std::array<float, NUM_PARTICLES> scratchTheta;
+        std::uint32_t seed = 2474;
+        pros::Task* task = nullptr;
+};
+} // namespace atlas
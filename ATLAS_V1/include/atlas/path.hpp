@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+#include "lemlib/asset.hpp"
+#include "lemlib/pose.hpp"
+
+namespace atlas {
+/**
+ * @brief A path asset to follow as part of a longer path
+ *
+ * @b Example
+ * @code {.cpp}
+ * ASSET(leftsecond_txt);
+ * ASSET(park_path_txt);
+ * // follow both paths as one, reversing into park at up to 80 power
+ * chassis.follow({{leftsecond_txt}, {park_path_txt, false, 80}}, 15, 8000);
+ * @endcode
+ */
+struct PathSegment {
+        /** the path asset, in the LemLib format exported by path.jerryio */
+        const asset& path;
+        /** whether the robot drives this segment forwards. true by default */
+        bool forwards = true;
+        /** the maximum speed the robot can travel at on this segment. Value between 0-127. 127 by default */
+        float maxSpeed = 127;
+};
+
+/**
+ * @brief A continuous run of path points driven in the same direction
+ *
+ * The theta of each point holds the target speed at that point, like the paths LemLib follows.
+ */
+struct PathRun {
+        std::vector<lemlib::Pose> points;
+        bool forwards = true;
+        /** lookahead keyframe value at each point, between 0 and 1. Negative where the path has no keyframes */
+        std::vector<float> lookaheadRatios;
+};
+
+/**
+ * @brief Get the points of a path asset
+ *
+ * @param path the path asset, in the LemLib format exported by path.jerryio
+ * @return std::vector<lemlib::Pose> the path points. The theta of each point is the target speed
+ */
+std::vector<lemlib::Pose> getPathPoints(const asset& path);
+
+/**
+ * @brief Get the lookahead keyframe value at each point of a path asset
+ *
+ * path.jerryio stores lookahead keyframes per bezier segment in the JSON at the end of the asset. The position of a
+ * keyframe is a fraction along its bezier segment, and its value is a fraction between the minimum and maximum
+ * lookahead. Each keyframe applies from its position until the next keyframe.
+ *
+ * @param path the path asset, in the LemLib format exported by path.jerryio
+ * @param points the points of the path asset
+ * @return std::vector<float> the keyframe value at each point, between 0 and 1. Negative before the first keyframe,
+ * or everywhere if the path has no keyframes
+ */
+std::vector<float> getLookaheadRatios(const asset& path, const std::vector<lemlib::Pose>& points);
+
+/**
+ * @brief Parse a path asset ahead of time
+ *
+ * Parsing a path takes a few milliseconds, which would otherwise delay the start of the motion that follows it.
+ * Preloaded paths are parsed once and kept, so following them starts straight away. Safe to call from any task.
+ *
+ * @param path the path asset, in the LemLib format exported by path.jerryio
+ *
+ * @b Example
+ * @code {.cpp}
+ * ASSET(leftsecond_txt);
+ * void initialize() {
+ *     atlas::preloadPath(leftsecond_txt);
+ * }
+ * @endcode
+ */
+void preloadPath(const asset& path);
+
+/**
+ * @brief Join path segments into continuous runs
+ *
+ * Consecutive segments driven in the same direction are joined into a single run. path.jerryio slows every segment
+ * down to a stop at its end and speeds it up from its start, so at each joint the stopping points are dropped, and the
+ * ramps on either side are raised to the slower of the two top speeds, which is already capped by each segment's
+ * maxSpeed. The robot does not slow down at the joints, and only the last segment of a run keeps its ramp down to a
+ * stop. The robot has to stop where the direction changes, so a new run is started there.
+ *
+ * @param segments the segments to join, in order
+ * @return std::vector<PathRun> the runs, in order
+ */
+std::vector<PathRun> joinSegments(const std::vector<PathSegment>& segments);
+} // namespace atlas
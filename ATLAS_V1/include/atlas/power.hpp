@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "pros/motor_group.hpp"
+#include "pros/rtos.hpp"
+
+namespace atlas {
+/** most drivetrain motors a PowerManager can manage */
+constexpr int MAX_DRIVE_MOTORS = 8;
+
+/**
+ * @brief Keeps the drivetrain from overheating over a match
+ *
+ * V5 motors halve their power at 55C and stop at 70C, so a drivetrain that is pushed hard early in a match is slow at
+ * the end. The PowerManager reads the temperature, current and power of every drive motor in one pass and lowers the
+ * current limit of the whole drivetrain as the hottest motor heats up, so the drivetrain slows down gradually and
+ * evenly instead of one motor throttling at the end. The limit is also lowered when the battery sags, so the drive
+ * doesn't brown out the brain.
+ *
+ * Every motor gets the same limit, so the robot still drives straight.
+ *
+ * Chassis::setVoltageCompensation pushes the drive harder as the battery sags, which is exactly when the sag limit
+ * would turn it down and clip the compensation. Call setVoltageCompensated when compensation is on, so only the
+ * temperature lowers the limit.
+ */
+class PowerManager {
+    public:
+        /**
+         * @brief Create a new PowerManager
+         *
+         * @param leftMotors the left motors of the drivetrain
+         * @param rightMotors the right motors of the drivetrain
+         */
+        PowerManager(pros::MotorGroup* leftMotors, pros::MotorGroup* rightMotors);
+        /**
+         * @brief Read the motors and update the current limit
+         *
+         * Called by the update task.
+         */
+        void update();
+        /**
+         * @brief Start managing in a low priority task
+         */
+        void start();
+        /**
+         * @brief Tell the PowerManager whether the drivetrain output is voltage compensated
+         *
+         * @param compensated true if Chassis::setVoltageCompensation is on, so the battery sag doesn't lower the
+         * limit. false by default
+         */
+        void setVoltageCompensated(bool compensated);
+        /**
+         * @brief Get the temperature of the hottest drive motor
+         *
+         * @return float temperature in degrees Celsius
+         */
+        float getMaxTemperature() const;
+        /**
+         * @brief Get the current drawn by the whole drivetrain
+         *
+         * @return float current in mA
+         */
+        float getTotalCurrent() const;
+        /**
+         * @brief Get the power drawn by the whole drivetrain
+         *
+         * @return float power in W
+         */
+        float getTotalPower() const;
+        /**
+         * @brief Get the current limit applied to every drive motor
+         *
+         * @return int the limit in mA
+         */
+        int getCurrentLimit() const;
+    private:
+        std::array<std::int8_t, MAX_DRIVE_MOTORS> ports {};
+        int motorCount = 0;
+        std::atomic<float> maxTemperature = 0;
+        std::atomic<float> totalCurrent = 0;
+        std::atomic<float> totalPower = 0;
+        std::atomic<int> currentLimit = 0; // 0 until the first update sets it
+        std::atomic<bool> voltageCompensated = false;
+        bool throttling = false;
+        bool wasOverTemp = false;
+        pros::Task* task = nullptr;
+};
+} // namespace atlas
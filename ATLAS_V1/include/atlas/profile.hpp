@@ -0,0 +1,95 @@
+#pragma once
+
+namespace atlas {
+/**
+ * @brief Settings for a motion profile
+ *
+ * The maximum velocity and acceleration are derived from the drivetrain, so they stay correct if the gearing or
+ * track width changes.
+ */
+class ProfileSettings {
+    public:
+        /**
+         * @brief Create a new ProfileSettings object
+         *
+         * @param speedRatio fraction of the theoretical maximum velocity the profile cruises at (0-1]
+         * @param accelTime time to accelerate from rest to the cruise velocity, in seconds
+         * @param kA acceleration feedforward, in motor power per unit/s^2. 0 by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // cruise at 80% of the theoretical turn rate, and reach it in 0.25 seconds
+         * atlas::ProfileSettings angularProfile(0.8, 0.25);
+         * @endcode
+         */
+        ProfileSettings(float speedRatio, float accelTime, float kA = 0)
+            : speedRatio(speedRatio),
+              accelTime(accelTime),
+              kA(kA) {}
+
+        float speedRatio;
+        float accelTime;
+        float kA;
+};
+
+/**
+ * @brief A state sampled from a motion profile
+ */
+struct ProfileState {
+        float position;
+        float velocity;
+        float acceleration;
+};
+
+/**
+ * @brief Trapezoidal motion profile
+ *
+ * Accelerates from the start velocity to the cruise velocity, cruises, then decelerates to the end velocity so the
+ * distance is covered in the shortest time the constraints allow. If the distance is too short to reach the cruise
+ * velocity, the profile becomes triangular. Distances and velocities are unsigned.
+ */
+class TrapezoidalProfile {
+    public:
+        /**
+         * @brief Create a new trapezoidal profile
+         *
+         * @param distance distance to travel
+         * @param maxVelocity maximum velocity
+         * @param maxAccel maximum acceleration and deceleration
+         * @param startVelocity velocity at the start of the profile. 0 by default
+         * @param endVelocity velocity at the end of the profile. 0 by default
+         *
+         * @b Example
+         * @code {.cpp}
+         * // 90 degree turn at up to 500 deg/s, accelerating at 2000 deg/s^2
+         * atlas::TrapezoidalProfile profile(90, 500, 2000);
+         * // where the robot should be 0.1 seconds in
+         * atlas::ProfileState state = profile.sample(0.1);
+         * @endcode
+         */
+        TrapezoidalProfile(float distance, float maxVelocity, float maxAccel, float startVelocity = 0,
+                           float endVelocity = 0);
+        /**
+         * @brief Sample the profile
+         *
+         * @param time time since the start of the profile, in seconds
+         * @return ProfileState the position, velocity and acceleration at that time
+         */
+        ProfileState sample(float time) const;
+        /**
+         * @brief Get how long the profile takes
+         *
+         * @return float duration in seconds
+         */
+        float getDuration() const;
+    private:
+        float distance;
+        float accel;
+        float startVelocity;
+        float cruiseVelocity;
+        float endVelocity;
+        float accelTime;
+        float cruiseTime;
+        float decelTime;
+};
+} // namespace atlas
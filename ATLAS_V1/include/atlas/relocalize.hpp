@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include "pros/distance.hpp"
+#include "lemlib/pose.hpp"
+#include "atlas/ekf.hpp"
+
+namespace atlas {
+/** distance from the center of the field to the inside of each wall, in inches */
+constexpr float FIELD_HALF_WIDTH = 70.2;
+
+/**
+ * @brief A distance sensor used to correct odometry against the field walls
+ *
+ * When the sensor is pointing at a wall, the distance it measures is compared against the distance to that wall
+ * predicted from the odometry pose, and the difference corrects the pose. Readings are skipped near corners, at
+ * shallow angles to the wall and at low confidence, where they are unreliable. Readings off game elements or other
+ * robots are far from the predicted distance, so the filter rejects them.
+ *
+ * Poses are in the field frame, with the origin at the center of the field.
+ */
+class DistanceSensor {
+    public:
+        /**
+         * @brief Create a new DistanceSensor
+         *
+         * @param sensor the distance sensor
+         * @param xOffset how far the sensor is to the right of the tracking center, in inches
+         * @param yOffset how far the sensor is in front of the tracking center, in inches
+         * @param angle the direction the sensor faces relative to the front of the robot, in degrees. Clockwise is
+         * positive, so a sensor facing right is 90
+         *
+         * @b Example
+         * @code {.cpp}
+         * pros::Distance left_distance(3);
+         * // sensor 5 inches left of the tracking center, facing left
+         * atlas::DistanceSensor left_wall(&left_distance, -5, 0, -90);
+         * @endcode
+         */
+        DistanceSensor(pros::Distance* sensor, float xOffset, float yOffset, float angle);
+        /**
+         * @brief Predict what the sensor should read
+         *
+         * @param pose the pose of the robot, theta in radians
+         * @return std::optional<float> distance to the wall the sensor faces, in inches. std::nullopt if the sensor
+         * isn't facing a wall squarely enough to trust
+         */
+        std::optional<float> predict(lemlib::Pose pose) const;
+        /**
+         * @brief Read the sensor
+         *
+         * This only reads the last value the sensor sent to the brain, so it never waits on the sensor.
+         *
+         * @return std::optional<float> the measured distance, in inches. std::nullopt if the reading is out of range
+         * or has low confidence
+         */
+        std::optional<float> read() const;
+        /**
+         * @brief Correct a pose estimate with the sensor, if it has a new reading of a wall
+         *
+         * @param ekf the pose estimate to correct
+         * @return true the estimate was corrected
+         * @return false there was no usable reading
+         */
+        bool correct(Ekf& ekf);
+        /**
+         * @brief Get how far the sensor is to the right of the tracking center
+         *
+         * @return float offset in inches
+         */
+        float getXOffset() const;
+        /**
+         * @brief Get how far the sensor is in front of the tracking center
+         *
+         * @return float offset in inches
+         */
+        float getYOffset() const;
+        /**
+         * @brief Get the direction the sensor faces relative to the front of the robot
+         *
+         * @return float angle in radians, clockwise positive
+         */
+        float getAngle() const;
+    private:
+        pros::Distance* sensor;
+        float xOffset;
+        float yOffset;
+        float angle;
+        float prevReading = -1;
+};
+} // namespace atlas
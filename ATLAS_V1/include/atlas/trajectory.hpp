@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include "lemlib/pose.hpp"
+
+namespace atlas {
+/**
+ * @brief A state sampled from a trajectory
+ */
+struct TrajectoryState {
+        /** where the robot should be. Theta is the heading of the robot in radians, in standard form */
+        lemlib::Pose pose;
+        /** how fast the robot should be moving, in inches per second. Negative when driving backwards */
+        float velocity;
+        /** how fast the robot should be turning, in radians per second. Positive is counter-clockwise */
+        float angularVelocity;
+};
+
+/**
+ * @brief A path parameterized by time
+ *
+ * The speeds on the path are scaled to the velocity of the drivetrain, limited so the outer wheel never exceeds the
+ * maximum velocity on curves, then limited by the maximum acceleration both forwards and backwards along the path.
+ * The trajectory ends at the first point where the path speed is 0.
+ */
+class Trajectory {
+    public:
+        /**
+         * @brief Create a new trajectory
+         *
+         * @param points the path points. The theta of each point is the target speed, out of 127
+         * @param forwards whether the robot drives the path forwards
+         * @param maxVelocity maximum wheel velocity, in inches per second
+         * @param maxAccel maximum acceleration, in inches per second squared
+         * @param trackWidth track width of the drivetrain, in inches
+         * @param startVelocity velocity of the robot at the start of the trajectory, in inches per second. 0 by
+         * default
+         */
+        Trajectory(const std::vector<lemlib::Pose>& points, bool forwards, float maxVelocity, float maxAccel,
+                   float trackWidth, float startVelocity = 0);
+        /**
+         * @brief Sample the trajectory
+         *
+         * @param time time since the start of the trajectory, in seconds
+         * @return TrajectoryState the state of the robot at that time
+         */
+        TrajectoryState sample(float time) const;
+        /**
+         * @brief Get how long the trajectory takes
+         *
+         * @return float duration in seconds
+         */
+        float getDuration() const;
+    private:
+        /**
+         * @brief A point on the trajectory
+         */
+        struct Point {
+                float x;
+                float y;
+                float heading;
+                float curvature;
+                float velocity;
+                float distance;
+                float time;
+        };
+
+        std::vector<Point> points;
+        bool forwards;
+};
+} // namespace atlas
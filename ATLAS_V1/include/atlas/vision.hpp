@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include "pros/ai_vision.hpp"
+#include "pros/rtos.hpp"
+#include "lemlib/pose.hpp"
+
+namespace atlas {
+/** most objects read from the AI Vision sensor in a frame */
+constexpr int MAX_DETECTIONS = 16;
+/** most game elements tracked at once */
+constexpr int MAX_TRACKS = 8;
+
+/**
+ * @brief Where the AI Vision sensor is mounted on the robot
+ */
+class CameraMount {
+    public:
+        /**
+         * @brief Create a new CameraMount object
+         *
+         * @param xOffset how far the camera is to the right of the tracking center, in inches
+         * @param yOffset how far the camera is in front of the tracking center, in inches
+         * @param height height of the camera lens above the floor, in inches
+         * @param angle the direction the camera faces relative to the front of the robot, in degrees. Clockwise is
+         * positive
+         * @param pitch how far the camera is tilted down from level, in degrees
+         *
+         * @b Example
+         * @code {.cpp}
+         * // camera 6 inches in front of the tracking center, 10 inches off the floor, tilted down 20 degrees
+         * atlas::CameraMount mount(0, 6, 10, 0, 20);
+         * @endcode
+         */
+        CameraMount(float xOffset, float yOffset, float height, float angle, float pitch)
+            : xOffset(xOffset),
+              yOffset(yOffset),
+              height(height),
+              angle(angle),
+              pitch(pitch) {}
+
+        float xOffset;
+        float yOffset;
+        float height;
+        float angle;
+        float pitch;
+};
+
+/**
+ * @brief A game element tracked on the field
+ */
+struct VisionTarget {
+        /** id of the detection. The color, code, tag or AI model element id */
+        std::uint8_t id = 0;
+        /** position on the field, in inches */
+        float x = 0;
+        float y = 0;
+        /** number of frames the element has been seen in */
+        int hits = 0;
+        /** when the element was last seen, in milliseconds */
+        std::uint32_t lastSeen = 0;
+};
+
+/**
+ * @brief Tracks game elements seen by an AI Vision sensor in field coordinates
+ *
+ * The bottom center of each detection is where the element touches the floor, so it is projected onto the floor from
+ * the camera mount and the odometry pose. Projected detections are matched to the nearest track with the same id,
+ * which smooths out the noise between frames and keeps elements that are briefly hidden. Everything is stored in
+ * fixed size arrays, so tracking never allocates.
+ *
+ * Poses are in the field frame, like odometry.
+ */
+class VisionTracker {
+    public:
+        /**
+         * @brief Create a new VisionTracker
+         *
+         * @param sensor the AI Vision sensor
+         * @param mount where the sensor is mounted
+         * @param targetHeight height of the bottom of the game elements above the floor, in inches. 0 by default
+         */
+        VisionTracker(pros::AIVision* sensor, CameraMount mount, float targetHeight = 0);
+        /**
+         * @brief Read a frame from the sensor and update the tracks
+         *
+         * @param pose the pose of the robot when the frame was taken, theta in radians
+         */
+        void update(lemlib::Pose pose);
+        /**
+         * @brief Get the nearest tracked game element
+         *
+         * Only elements seen in several frames are returned, so a single false detection is never driven to.
+         *
+         * @param id the id of the element to look for
+         * @param pose the pose to measure from, theta unused
+         * @return std::optional<VisionTarget> the nearest element, std::nullopt if none are being tracked
+         *
+         * @b Example
+         * @code {.cpp}
+         * std::optional<atlas::VisionTarget> ring = tracker.getNearest(1, chassis.getPose());
+         * if (ring) chassis.moveToPoint(ring->x, ring->y, 2000);
+         * @endcode
+         */
+        std::optional<VisionTarget> getNearest(std::uint8_t id, lemlib::Pose pose);
+        /**
+         * @brief Start tracking in a low priority task, at the rate the sensor sends frames
+         */
+        void start();
+    private:
+        /**
+         * @brief Project a detection onto the floor
+         *
+         * @param object the detection
+         * @param pose the pose of the robot, theta in radians
+         * @return std::optional<lemlib::Pose> position of the element on the field, std::nullopt if the detection is
+         * above the horizon
+         */
+        std::optional<lemlib::Pose> project(const pros::AIVision::Object& object, lemlib::Pose pose) const;
+
+        pros::AIVision* sensor;
+        CameraMount mount;
+        float targetHeight;
+        std::array<pros::AIVision::Object, MAX_DETECTIONS> detections;
+        std::array<VisionTarget, MAX_TRACKS> tracks;
+        pros::Mutex mutex;
+        pros::Task* task = nullptr;
+};
+} // namespace atlas
@@ -1,3 +1,6 @@
 #include "main.h"
+#include "atlas/intake.hpp"
 extern pros::Motor A7;
 extern pros::Motor A8;
+extern atlas::Intake intake_stage1;
+extern atlas::Intake intake_stage2;
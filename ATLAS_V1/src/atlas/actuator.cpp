@@ -0,0 +1,45 @@
+#include "pros/rtos.hpp"
+#include "atlas/actuator.hpp"
+
+atlas::CachedMotor::CachedMotor(pros::Motor* motor)
+    : motor(motor) {}
+
+bool atlas::CachedMotor::update(Mode mode, int value) {
+    const std::uint32_t now = pros::millis();
+    if (mode == this->mode && value == this->value && now - lastWrite < REFRESH_PERIOD) return false;
+    this->mode = mode;
+    this->value = value;
+    lastWrite = now;
+    return true;
+}
+
+void atlas::CachedMotor::move(int power) {
+    if (update(Mode::POWER, power)) motor->move(power);
+}
+
+void atlas::CachedMotor::moveVoltage(int voltage) {
+    if (update(Mode::VOLTAGE, voltage)) motor->move_voltage(voltage);
+}
+
+void atlas::CachedMotor::moveVelocity(int velocity) {
+    if (update(Mode::VELOCITY, velocity)) motor->move_velocity(velocity);
+}
+
+pros::Motor* atlas::CachedMotor::getMotor() const { return motor; }
+
+atlas::CachedPneumatics::CachedPneumatics(pros::adi::Pneumatics* pneumatics)
+    : pneumatics(pneumatics),
+      extended(pneumatics->is_extended()) {}
+
+void atlas::CachedPneumatics::set(bool extended) {
+    const std::uint32_t now = pros::millis();
+    if (extended == this->extended && lastWrite != 0 && now - lastWrite < REFRESH_PERIOD) return;
+    this->extended = extended;
+    lastWrite = now;
+    if (extended) pneumatics->extend();
+    else pneumatics->retract();
+}
+
+void atlas::CachedPneumatics::toggle() { set(!extended); }
+
+bool atlas::CachedPneumatics::isExtended() const { return extended; }
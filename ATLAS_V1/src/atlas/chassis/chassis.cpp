@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "pros/error.h"
+#include "pros/misc.h"
+#include "pros/rtos.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/util.hpp"
+#include "atlas/chassis/chassis.hpp"
+#include "atlas/chassis/odom.hpp"
+
+// highest voltage the motors take, in mV
+constexpr float MAX_VOLTAGE = 12000;
+// how much each battery reading moves the filtered voltage, so one noisy reading doesn't jerk the motors
+constexpr float BATTERY_WEIGHT = 0.2;
+
+atlas::Chassis::Chassis(lemlib::Drivetrain drivetrain, lemlib::ControllerSettings linearSettings,
+                        lemlib::ControllerSettings angularSettings, SettleSettings lateralSettle,
+                        SettleSettings angularSettle, ProfileSettings lateralProfile, ProfileSettings angularProfile,
+                        OdomSensors sensors, const LookupDriveCurve* throttleCurve,
+                        const LookupDriveCurve* steerCurve)
+    : lemlib::Chassis(drivetrain, linearSettings, angularSettings, sensors),
+      odomSensors(sensors),
+      lateralSettleExit(lateralSettle),
+      angularSettleExit(angularSettle),
+      lateralProfile(lateralProfile),
+      angularProfile(angularProfile),
+      throttleLookup(throttleCurve),
+      steerLookup(steerCurve) {}
+
+atlas::Calibration::Calibration(std::shared_ptr<std::atomic<bool>> done)
+    : done(done) {}
+
+bool atlas::Calibration::isDone() const { return *done; }
+
+void atlas::Calibration::waitUntilDone() const {
+    while (!*done) pros::delay(10);
+}
+
+atlas::Calibration atlas::Chassis::calibrate(bool calibrateIMU, bool async) {
+    auto done = std::make_shared<std::atomic<bool>>(false);
+    if (async) {
+        pros::Task task([this, calibrateIMU, done] {
+            calibrateSensors(calibrateIMU);
+            *done = true;
+        });
+    } else {
+        calibrateSensors(calibrateIMU);
+        *done = true;
+    }
+    return Calibration(done);
+}
+
+void atlas::Chassis::calibrateSensors(bool calibrateIMU) {
+    // calibrate the IMUs if they exist and the user doesn't specify otherwise
+    if (!odomSensors.imus.empty() && calibrateIMU) {
+        // calibrate every IMU at once, so more IMUs don't take any longer
+        std::vector<pros::Imu*> uncalibrated = odomSensors.imus;
+        int attempt = 1;
+        // calibrate inertial, and if calibration fails, then repeat 5 times or until successful
+        while (attempt <= 5) {
+            for (pros::Imu* imu : uncalibrated) imu->reset();
+            // wait until the IMUs are calibrated
+            for (pros::Imu* imu : uncalibrated) {
+                do pros::delay(10);
+                while (imu->get_status() != pros::ImuStatus::error && imu->is_calibrating());
+            }
+            // keep the IMUs that failed for the next attempt
+            std::erase_if(uncalibrated, [](pros::Imu* imu) {
+                return !std::isnan(imu->get_heading()) && !std::isinf(imu->get_heading());
+            });
+            if (uncalibrated.empty()) break;
+            // indicate error
+            pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, "---");
+            lemlib::infoSink()->warn("{} IMU(s) failed to calibrate! Attempt #{}", uncalibrated.size(), attempt);
+            attempt++;
+        }
+        // stop using the IMUs that never calibrated
+        std::erase_if(odomSensors.imus, [&](pros::Imu* imu) {
+            return std::find(uncalibrated.begin(), uncalibrated.end(), imu) != uncalibrated.end();
+        });
+        odomSensors.imu = odomSensors.imus.empty() ? nullptr : odomSensors.imus[0];
+        if (odomSensors.imus.empty())
+            lemlib::infoSink()->error("IMU calibration failed, defaulting to tracking wheels / motor encoders");
+    }
+    // substitute the drivetrain for missing vertical tracking wheels
+    if (odomSensors.vertical1 == nullptr)
+        odomSensors.vertical1 = new lemlib::TrackingWheel(drivetrain.leftMotors, drivetrain.wheelDiameter,
+                                                          -(drivetrain.trackWidth / 2), drivetrain.rpm);
+    if (odomSensors.vertical2 == nullptr)
+        odomSensors.vertical2 = new lemlib::TrackingWheel(drivetrain.rightMotors, drivetrain.wheelDiameter,
+                                                          drivetrain.trackWidth / 2, drivetrain.rpm);
+    odomSensors.vertical1->reset();
+    odomSensors.vertical2->reset();
+    if (odomSensors.horizontal1 != nullptr) odomSensors.horizontal1->reset();
+    if (odomSensors.horizontal2 != nullptr) odomSensors.horizontal2->reset();
+    // keep the LemLib copy of the sensors the same, in case a LemLib motion reads them
+    sensors = odomSensors;
+    // start atlas odometry. LemLib odometry is never started, so it can't overwrite the filtered pose
+    atlas::setSensors(odomSensors, drivetrain);
+    atlas::init();
+    // rumble to controller to indicate success
+    pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, ".");
+}
+
+void atlas::Chassis::setPose(float x, float y, float theta, bool radians) {
+    atlas::setPose(lemlib::Pose(x, y, theta), radians);
+}
+
+void atlas::Chassis::setPose(lemlib::Pose pose, bool radians) { atlas::setPose(pose, radians); }
+
+void atlas::Chassis::setVoltageCompensation(std::optional<float> nominalVoltage) {
+    this->nominalVoltage = nominalVoltage;
+    batteryVoltage = 0;
+}
+
+void atlas::Chassis::moveMotors(pros::MotorGroup* motors, float power) {
+    if (!nominalVoltage) {
+        motors->move(power);
+        return;
+    }
+    const std::int32_t voltage = pros::c::battery_get_voltage();
+    if (voltage != PROS_ERR && voltage > 0) {
+        batteryVoltage = batteryVoltage == 0 ? voltage : lemlib::ema(voltage, batteryVoltage, BATTERY_WEIGHT);
+    }
+    // scale up by how far the battery has sagged, until the motors are at full voltage
+    const float scale = batteryVoltage == 0 ? 1 : *nominalVoltage / batteryVoltage;
+    motors->move_voltage(std::clamp(power / 127 * MAX_VOLTAGE * scale, -MAX_VOLTAGE, MAX_VOLTAGE));
+}
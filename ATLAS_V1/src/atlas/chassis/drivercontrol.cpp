@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cmath>
+#include "pros/error.h"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/util.hpp"
+#include "atlas/chassis/chassis.hpp"
+#include "atlas/chassis/odom.hpp"
+
+// acceleration of gravity, in in/s^2. The IMU reports acceleration in g
+constexpr float GRAVITY = 386.09;
+// longest time between driver control updates before traction control starts over, in ms
+constexpr std::uint32_t TRACTION_TIMEOUT = 100;
+// how much the ground speed is pulled towards the wheels every update while they grip. This removes IMU drift
+constexpr float WHEEL_WEIGHT = 0.05;
+// the heading to hold is taken once the robot turns slower than this, in degrees per second
+constexpr float HOLD_TURN_RATE = 30;
+
+/**
+ * @brief Get the average velocity of every motor in a motor group
+ *
+ * Every motor is read, so one motor spinning out doesn't decide the speed of the whole side
+ *
+ * @param motors the motor group
+ * @return float the average velocity, in rpm. NaN if no motor could be read
+ */
+static float averageVelocity(pros::MotorGroup* motors) {
+    float sum = 0;
+    int count = 0;
+    for (double velocity : motors->get_actual_velocity_all()) {
+        if (velocity == PROS_ERR_F) continue;
+        sum += velocity;
+        count++;
+    }
+    return count == 0 ? NAN : sum / count;
+}
+
+/**
+ * @brief Get the top speed of the cartridge in a motor group
+ *
+ * @param motors the motor group
+ * @return float the top speed, in rpm
+ */
+static float cartridgeRpm(pros::MotorGroup* motors) {
+    switch (motors->get_gearing()) {
+        case pros::MotorGears::red: return 100;
+        case pros::MotorGears::blue: return 600;
+        default: return 200;
+    }
+}
+
+void atlas::Chassis::tank(int left, int right, bool disableDriveCurve) {
+    if (!disableDriveCurve) {
+        left = throttleLookup->curve(left);
+        right = throttleLookup->curve(right);
+    }
+    driveSides(left, right);
+}
+
+void atlas::Chassis::arcade(int throttle, int turn, bool disableDriveCurve, float desaturateBias) {
+    int newThrottle = throttle;
+    int newTurn = turn;
+    if (!disableDriveCurve) {
+        newThrottle = throttleLookup->curve(throttle);
+        newTurn = steerLookup->curve(turn);
+    }
+    if (const std::optional<float> correction = holdHeading(throttle, turn)) newTurn = std::lround(*correction);
+    // desaturate based on desaturateBias
+    if (std::abs(newThrottle) + std::abs(newTurn) > 127) {
+        const int oldThrottle = newThrottle;
+        const int oldTurn = newTurn;
+        newThrottle *= (1 - desaturateBias * std::abs(oldTurn / 127.0));
+        newTurn *= (1 - (1 - desaturateBias) * std::abs(oldThrottle / 127.0));
+    }
+    driveSides(newThrottle + newTurn, newThrottle - newTurn);
+}
+
+void atlas::Chassis::curvature(int throttle, int turn, bool disableDriveCurve) {
+    // if we're not moving forwards change to arcade drive
+    if (throttle == 0) {
+        arcade(throttle, turn, disableDriveCurve);
+        return;
+    }
+    // curvature scales the turn with the throttle, which is too weak to hold the heading at low speed, so mix the
+    // correction in like arcade
+    if (const std::optional<float> correction = holdHeading(throttle, turn)) {
+        const float power = disableDriveCurve ? throttle : throttleLookup->curve(throttle);
+        driveSides(power + *correction, power - *correction);
+        return;
+    }
+    float leftPower = throttle + (std::abs(throttle) * turn) / 127.0;
+    float rightPower = throttle - (std::abs(throttle) * turn) / 127.0;
+    if (!disableDriveCurve) {
+        leftPower = throttleLookup->curve(std::lround(leftPower));
+        rightPower = throttleLookup->curve(std::lround(rightPower));
+    }
+    driveSides(leftPower, rightPower);
+}
+
+void atlas::Chassis::setTractionControl(std::optional<TractionSettings> settings) {
+    if (settings && odomSensors.imus.empty()) {
+        lemlib::infoSink()->warn("Traction control needs an IMU, leaving it off");
+        return;
+    }
+    traction = settings;
+    tractionTime = 0;
+}
+
+void atlas::Chassis::setHeadingHold(std::optional<lemlib::PID> pid) {
+    // lemlib::PID can't be assigned, so it is rebuilt in place
+    if (pid) headingPID.emplace(*pid);
+    else headingPID.reset();
+    holding = false;
+}
+
+std::optional<float> atlas::Chassis::holdHeading(int throttle, int turn) {
+    // only hold while driving with the turn stick centered
+    if (!headingPID || throttleLookup->curve(throttle) == 0 || steerLookup->curve(turn) != 0) {
+        holding = false;
+        return std::nullopt;
+    }
+    const float heading = getPose().theta;
+    if (!holding) {
+        // wait for the last turn to stop, so the robot doesn't swing back to where the stick was let go
+        if (std::fabs(getLocalSpeed().theta) > HOLD_TURN_RATE) return std::nullopt;
+        holding = true;
+        holdTarget = heading;
+        headingPID->reset();
+    }
+    return std::clamp(headingPID->update(lemlib::angleError(holdTarget, heading, false)), -127.0f, 127.0f);
+}
+
+void atlas::Chassis::driveSides(float left, float right) {
+    tractionControl(left, right);
+    moveMotors(drivetrain.leftMotors, left);
+    moveMotors(drivetrain.rightMotors, right);
+}
+
+void atlas::Chassis::tractionControl(float& left, float& right) {
+    if (!traction) return;
+    const std::uint32_t now = pros::millis();
+    const float leftRpm = averageVelocity(drivetrain.leftMotors);
+    const float rightRpm = averageVelocity(drivetrain.rightMotors);
+    const pros::imu_accel_s_t accel = odomSensors.imus[0]->get_accel();
+    if (std::isnan(leftRpm) || std::isnan(rightRpm) || accel.y == PROS_ERR_F) return;
+
+    // speed of the wheels of each side, in inches per second
+    const float rpmToSpeed =
+        M_PI * drivetrain.wheelDiameter / 60 * drivetrain.rpm / cartridgeRpm(drivetrain.leftMotors);
+    const float leftSpeed = leftRpm * rpmToSpeed;
+    const float rightSpeed = rightRpm * rpmToSpeed;
+    // how much faster the left side moves over the ground than the middle, and the right side slower, while turning
+    const float turnSpeed = getLocalSpeed(true).theta * drivetrain.trackWidth / 2;
+
+    if (tractionTime == 0 || now - tractionTime > TRACTION_TIMEOUT) {
+        // starting over, so trust the wheels
+        groundSpeed = (leftSpeed + rightSpeed) / 2;
+        leftTraction = 1;
+        rightTraction = 1;
+    } else groundSpeed += accel.y * GRAVITY * (now - tractionTime) / 1000;
+    tractionTime = now;
+
+    // a side slips when its wheels outrun the ground under it, in the direction it is pushed
+    const auto slipping = [this](float power, float wheelSpeed, float sideSpeed) {
+        return power != 0 && (wheelSpeed - sideSpeed) * (power > 0 ? 1 : -1) > traction->slipSpeed;
+    };
+    const bool leftSlip = slipping(left, leftSpeed, groundSpeed + turnSpeed);
+    const bool rightSlip = slipping(right, rightSpeed, groundSpeed - turnSpeed);
+    if (!leftSlip && !rightSlip) groundSpeed = lemlib::ema((leftSpeed + rightSpeed) / 2, groundSpeed, WHEEL_WEIGHT);
+
+    // back off a slipping side, and give the output back once it grips
+    const auto adjust = [this](float& gain, bool slip) {
+        if (slip) gain = std::max(gain - traction->backoff, traction->minOutput);
+        else gain = std::min(gain + traction->recovery, 1.0f);
+    };
+    adjust(leftTraction, leftSlip);
+    adjust(rightTraction, rightSlip);
+    left *= leftTraction;
+    right *= rightTraction;
+}
@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "pros/misc.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+#include "atlas/chassis/chassis.hpp"
+#include "atlas/chassis/odom.hpp"
+#include "atlas/trajectory.hpp"
+
+/**
+ * @brief find the index of the closest point on the path to the robot
+ *
+ * Only points from the previous closest point to window inches further along the path are considered, so the robot
+ * can't skip back to an earlier part of a path that crosses itself, or jump ahead to a later part of it
+ *
+ * @param pose the position of the robot
+ * @param path the path
+ * @param start index of the previous closest point
+ * @param window how far along the path to search from the previous closest point, in inches
+ * @return int index of the closest point
+ */
+static int findClosest(lemlib::Pose pose, const std::vector<lemlib::Pose>& path, int start, float window) {
+    int closestPoint = start;
+    float closestDist = std::numeric_limits<float>::infinity();
+    float searched = 0; // distance along the path from the previous closest point
+    for (int i = start; i < int(path.size()); i++) {
+        if (i > start) searched += path.at(i - 1).distance(path.at(i));
+        if (searched > window) break;
+        const float dist = pose.distance(path.at(i));
+        if (dist < closestDist) { // new closest point
+            closestDist = dist;
+            closestPoint = i;
+        }
+    }
+    return closestPoint;
+}
+
+/**
+ * @brief find where a line segment intersects the lookahead circle
+ *
+ * @param p1 start of the line segment
+ * @param p2 end of the line segment
+ * @param pose the center of the circle
+ * @param lookaheadDist the radius of the circle
+ * @return float t value of the intersection along the segment, or -1 if there is none
+ */
+static float circleIntersect(lemlib::Pose p1, lemlib::Pose p2, lemlib::Pose pose, float lookaheadDist) {
+    // uses the quadratic formula to calculate intersection points
+    const lemlib::Pose d = p2 - p1;
+    const lemlib::Pose f = p1 - pose;
+    const float a = d * d;
+    const float b = 2 * (f * d);
+    const float c = (f * f) - lookaheadDist * lookaheadDist;
+    float discriminant = b * b - 4 * a * c;
+
+    // if a possible intersection was found
+    if (discriminant >= 0 && a != 0) {
+        discriminant = std::sqrt(discriminant);
+        const float t1 = (-b - discriminant) / (2 * a);
+        const float t2 = (-b + discriminant) / (2 * a);
+
+        // prioritize further down the path
+        if (t2 >= 0 && t2 <= 1) return t2;
+        else if (t1 >= 0 && t1 <= 1) return t1;
+    }
+
+    // no intersection found
+    return -1;
+}
+
+/**
+ * @brief find the lookahead point
+ *
+ * @param lastLookahead the previous lookahead point. Its theta is the index of the path segment it was on
+ * @param pose the position of the robot
+ * @param path the path
+ * @param closest index of the closest point on the path
+ * @param lookaheadDist the lookahead distance
+ * @return lemlib::Pose the lookahead point. Its theta is the index of the path segment it is on
+ */
+static lemlib::Pose lookaheadPoint(lemlib::Pose lastLookahead, lemlib::Pose pose, const std::vector<lemlib::Pose>& path,
+                                   int closest, float lookaheadDist) {
+    // only consider intersections at or past the closest point and the last lookahead point
+    const int start = std::max(closest, int(lastLookahead.theta));
+    for (int i = start; i < int(path.size()) - 1; i++) {
+        const lemlib::Pose lastPathPose = path.at(i);
+        const lemlib::Pose currentPathPose = path.at(i + 1);
+
+        const float t = circleIntersect(lastPathPose, currentPathPose, pose, lookaheadDist);
+
+        if (t != -1) {
+            lemlib::Pose lookahead = lastPathPose.lerp(currentPathPose, t);
+            lookahead.theta = i;
+            return lookahead;
+        }
+    }
+
+    // robot deviated from path, use last lookahead point
+    return lastLookahead;
+}
+
+/**
+ * @brief get the curvature of the arc between the robot and the lookahead point
+ *
+ * @param pose the position of the robot
+ * @param heading the heading of the robot, in radians and standard form
+ * @param lookahead the lookahead point
+ * @return float signed curvature
+ */
+static float findLookaheadCurvature(lemlib::Pose pose, float heading, lemlib::Pose lookahead) {
+    // calculate whether the robot is on the left or right side of the circle
+    const float side =
+        lemlib::sgn(std::sin(heading) * (lookahead.x - pose.x) - std::cos(heading) * (lookahead.y - pose.y));
+    // calculate center point and radius
+    const float a = -std::tan(heading);
+    const float c = std::tan(heading) * pose.x - pose.y;
+    const float x = std::fabs(a * lookahead.x + lookahead.y + c) / std::sqrt((a * a) + 1);
+    const float d = std::hypot(lookahead.x - pose.x, lookahead.y - pose.y);
+
+    // return curvature
+    return side * ((2 * x) / (d * d));
+}
+
+/**
+ * @brief get the unsigned curvature of the path at each point
+ *
+ * @param path the path
+ * @return std::vector<float> the curvature at each point, 0 at the ends
+ */
+static std::vector<float> getPathCurvatures(const std::vector<lemlib::Pose>& path) {
+    std::vector<float> curvatures(path.size(), 0);
+    for (int i = 1; i < int(path.size()) - 1; i++) {
+        const lemlib::Pose& a = path.at(i - 1);
+        const lemlib::Pose& b = path.at(i);
+        const lemlib::Pose& c = path.at(i + 1);
+        // curvature of the circle through the 3 points
+        const float cross = (b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x);
+        const float product = a.distance(b) * b.distance(c) * a.distance(c);
+        if (product > 0) curvatures.at(i) = std::fabs(2 * cross / product);
+    }
+    return curvatures;
+}
+
+/**
+ * @brief calculate the adaptive lookahead distance
+ *
+ * A lookahead keyframe on the path takes priority. Otherwise the lookahead grows with the speed of the robot, but is
+ * limited by the turn radius of the path ahead so the robot doesn't cut tight corners
+ *
+ * @param path the path
+ * @param curvatures the curvature of the path at each point
+ * @param keyframe the lookahead keyframe value at the closest point, or negative if there is none
+ * @param closest index of the closest point on the path
+ * @param speedRatio the speed of the robot, as a fraction of its max speed
+ * @param params adaptive lookahead settings
+ * @return float the lookahead distance
+ */
+static float adaptLookahead(const std::vector<lemlib::Pose>& path, const std::vector<float>& curvatures,
+                            float keyframe, int closest, float speedRatio, const atlas::FollowParams& params) {
+    const float range = params.maxLookahead - params.minLookahead;
+    if (keyframe >= 0) return params.minLookahead + keyframe * range;
+
+    float lookahead = params.minLookahead + std::clamp(speedRatio, 0.0f, 1.0f) * range;
+    // limit the lookahead by the tightest turn within it
+    float maxCurvature = 0;
+    float dist = 0;
+    for (int i = closest; i < int(path.size()) - 1 && dist < lookahead; i++) {
+        maxCurvature = std::fmax(maxCurvature, curvatures.at(i));
+        dist += path.at(i).distance(path.at(i + 1));
+    }
+    if (maxCurvature > 0) lookahead = std::fmin(lookahead, params.curvatureGain / maxCurvature);
+    return std::clamp(lookahead, params.minLookahead, params.maxLookahead);
+}
+
+void atlas::Chassis::follow(const asset& path, float lookahead, int timeout, bool forwards, FollowParams params,
+                            bool async) {
+    follow(std::vector<PathSegment> {{path, forwards}}, lookahead, timeout, params, async);
+}
+
+void atlas::Chassis::follow(std::vector<PathSegment> segments, float lookahead, int timeout, FollowParams params,
+                            bool async) {
+    // take the mutex
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([&]() { follow(segments, lookahead, timeout, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+
+    const std::vector<PathRun> runs = joinSegments(segments);
+    if (runs.empty()) {
+        lemlib::infoSink()->error("No points in path! Do you have the right format? Skipping motion");
+        // set distTraveled to -1 to indicate that the function has finished
+        distTraveled = -1;
+        // give the mutex back
+        this->endMotion();
+        return;
+    }
+
+    lemlib::Timer timer(timeout);
+    distTraveled = 0;
+    // the robot has to stop between runs, since the direction changes
+    for (const PathRun& run : runs) {
+        if (params.tracker == Tracker::RAMSETE) ramseteRun(run, params, timer);
+        else pursueRun(run, lookahead, params, timer);
+    }
+
+    // stop the robot
+    moveMotors(drivetrain.leftMotors, 0);
+    moveMotors(drivetrain.rightMotors, 0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+}
+
+void atlas::Chassis::pursueRun(const PathRun& run, float lookahead, const FollowParams& params,
+                               lemlib::Timer& timer) {
+    const std::vector<lemlib::Pose>& pathPoints = run.points;
+    const int compState = pros::competition::get_status();
+    const bool adaptive = params.minLookahead > 0 && params.maxLookahead >= params.minLookahead;
+    // theoretical max wheel velocity, in inches per second
+    const float maxVelocity = drivetrain.rpm / 60 * M_PI * drivetrain.wheelDiameter;
+    const std::vector<float> curvatures = getPathCurvatures(pathPoints);
+    lemlib::Pose lastPose = this->getPose(true);
+    lemlib::Pose lastLookahead = pathPoints.at(0);
+    lastLookahead.theta = 0;
+    int closestPoint = 0;
+    // the closest point can't move further than the lookahead in one update
+    const float searchWindow = adaptive ? params.maxLookahead : lookahead;
+    float prevVel = 0;
+
+    while (!timer.isDone() && pros::competition::get_status() == compState && this->motionRunning) {
+        // get the current position of the robot
+        lemlib::Pose pose = this->getPose(true);
+        if (!run.forwards) pose.theta -= M_PI;
+
+        // update completion vars
+        distTraveled += pose.distance(lastPose);
+        lastPose = pose;
+
+        // find the closest point on the path to the robot
+        closestPoint = findClosest(pose, pathPoints, closestPoint, searchWindow);
+        // if the robot is at the end of the run, then stop
+        if (pathPoints.at(closestPoint).theta == 0) break;
+
+        // adapt the lookahead distance
+        float lookaheadDist = lookahead;
+        if (adaptive) {
+            lookaheadDist = adaptLookahead(pathPoints, curvatures, run.lookaheadRatios.at(closestPoint), closestPoint,
+                                           std::fabs(atlas::getLocalSpeed().y) / maxVelocity, params);
+        }
+
+        // find the lookahead point
+        const lemlib::Pose lookaheadPose =
+            lookaheadPoint(lastLookahead, pose, pathPoints, closestPoint, lookaheadDist);
+        lastLookahead = lookaheadPose; // update last lookahead position
+
+        // get the curvature of the arc between the robot and the lookahead point
+        const float curvatureHeading = M_PI / 2 - pose.theta;
+        const float curvature = findLookaheadCurvature(pose, curvatureHeading, lookaheadPose);
+
+        // get the target velocity of the robot
+        float targetVel = pathPoints.at(closestPoint).theta;
+        targetVel = lemlib::slew(targetVel, prevVel, lateralSettings.slew);
+        prevVel = targetVel;
+
+        // calculate target left and right velocities
+        float targetLeftVel = targetVel * (2 + curvature * drivetrain.trackWidth) / 2;
+        float targetRightVel = targetVel * (2 - curvature * drivetrain.trackWidth) / 2;
+
+        // ratio the speeds to respect the max speed
+        const float ratio = std::max(std::fabs(targetLeftVel), std::fabs(targetRightVel)) / 127;
+        if (ratio > 1) {
+            targetLeftVel /= ratio;
+            targetRightVel /= ratio;
+        }
+
+        // move the drivetrain
+        if (run.forwards) {
+            moveMotors(drivetrain.leftMotors, targetLeftVel);
+            moveMotors(drivetrain.rightMotors, targetRightVel);
+        } else {
+            moveMotors(drivetrain.leftMotors, -targetRightVel);
+            moveMotors(drivetrain.rightMotors, -targetLeftVel);
+        }
+
+        pros::delay(10);
+    }
+}
+
+void atlas::Chassis::ramseteRun(const PathRun& run, const FollowParams& params, lemlib::Timer& timer) {
+    const int compState = pros::competition::get_status();
+    // theoretical max wheel velocity, in inches per second
+    const float maxVelocity = drivetrain.rpm / 60 * M_PI * drivetrain.wheelDiameter;
+    const lemlib::Pose speed = atlas::getLocalSpeed();
+    const Trajectory trajectory(run.points, run.forwards, lateralProfile.speedRatio * maxVelocity,
+                                lateralProfile.speedRatio * maxVelocity / lateralProfile.accelTime,
+                                drivetrain.trackWidth, std::fabs(speed.y));
+    const int startTime = pros::millis();
+    lemlib::Pose lastPose = this->getPose(true, true);
+
+    while (!timer.isDone() && pros::competition::get_status() == compState && this->motionRunning) {
+        const float time = (pros::millis() - startTime) / 1000.0;
+        if (time > trajectory.getDuration()) break;
+        const TrajectoryState target = trajectory.sample(time);
+        const lemlib::Pose pose = this->getPose(true, true);
+
+        // update completion vars
+        distTraveled += pose.distance(lastPose);
+        lastPose = pose;
+
+        // error in the local frame of the robot
+        const float dx = target.pose.x - pose.x;
+        const float dy = target.pose.y - pose.y;
+        const float errorX = std::cos(pose.theta) * dx + std::sin(pose.theta) * dy;
+        const float errorY = -std::sin(pose.theta) * dx + std::cos(pose.theta) * dy;
+        const float errorTheta = std::remainder(target.pose.theta - pose.theta, 2 * M_PI);
+
+        // Ramsete control law
+        const float k = 2 * params.zeta *
+                        std::sqrt(target.angularVelocity * target.angularVelocity +
+                                  params.b * target.velocity * target.velocity);
+        const float sinc = std::fabs(errorTheta) < 1e-3 ? 1 : std::sin(errorTheta) / errorTheta;
+        const float velocity = target.velocity * std::cos(errorTheta) + k * errorX;
+        const float angularVelocity =
+            target.angularVelocity + k * errorTheta + params.b * target.velocity * sinc * errorY;
+
+        // convert to wheel velocities, then to motor power
+        float leftPower = (velocity - angularVelocity * drivetrain.trackWidth / 2) / maxVelocity * 127;
+        float rightPower = (velocity + angularVelocity * drivetrain.trackWidth / 2) / maxVelocity * 127;
+        const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / 127;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+
+        lemlib::infoSink()->debug("Ramsete left: {} right: {}", leftPower, rightPower);
+
+        // move the drivetrain
+        moveMotors(drivetrain.leftMotors, leftPower);
+        moveMotors(drivetrain.rightMotors, rightPower);
+
+        pros::delay(10);
+    }
+}
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+#include "atlas/chassis/chassis.hpp"
+#include "atlas/chassis/odom.hpp"
+
+void atlas::Chassis::moveToPoint(float x, float y, int timeout, lemlib::MoveToPointParams params, bool async) {
+    params.earlyExitRange = std::fabs(params.earlyExitRange);
+    // take the mutex
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([&]() { moveToPoint(x, y, timeout, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+
+    // reset PIDs and exit conditions
+    lateralPID.reset();
+    lateralLargeExit.reset();
+    lateralSmallExit.reset();
+    lateralSettleExit.reset();
+    angularPID.reset();
+
+    // initialize vars used between iterations
+    lemlib::Pose lastPose = getPose();
+    distTraveled = 0;
+    lemlib::Timer timer(timeout);
+    bool close = false;
+    float prevLateralOut = 0; // previous lateral power
+    float prevAngularOut = 0; // previous angular power
+    std::optional<bool> prevSide = std::nullopt;
+
+    // calculate target pose in standard form
+    lemlib::Pose target(x, y);
+    target.theta = lastPose.angle(target);
+
+    // main loop
+    while (!timer.isDone() &&
+           ((!lateralSmallExit.getExit() && !lateralLargeExit.getExit() && !lateralSettleExit.getExit()) || !close) &&
+           this->motionRunning) {
+        // update position
+        const lemlib::Pose pose = getPose(true, true);
+
+        // update distance traveled
+        distTraveled += pose.distance(lastPose);
+        lastPose = pose;
+
+        // calculate distance to the target point
+        const float distTarget = pose.distance(target);
+
+        // check if the robot is close enough to the target to start settling
+        if (distTarget < 7.5 && close == false) {
+            close = true;
+            params.maxSpeed = std::fmax(std::fabs(prevLateralOut), 60);
+        }
+
+        // motion chaining
+        const bool side = (pose.y - target.y) * -std::sin(target.theta) <=
+                          (pose.x - target.x) * std::cos(target.theta) + params.earlyExitRange;
+        if (prevSide == std::nullopt) prevSide = side;
+        const bool sameSide = side == prevSide;
+        // exit if close
+        if (!sameSide && params.minSpeed != 0) break;
+        prevSide = side;
+
+        // calculate error
+        const float adjustedRobotTheta = params.forwards ? pose.theta : pose.theta + M_PI;
+        const float angularError = lemlib::angleError(adjustedRobotTheta, pose.angle(target));
+        float lateralError = pose.distance(target) * std::cos(lemlib::angleError(pose.theta, pose.angle(target)));
+
+        // update exit conditions
+        const lemlib::Pose speed = atlas::getLocalSpeed();
+        lateralSmallExit.update(lateralError);
+        lateralLargeExit.update(lateralError);
+        lateralSettleExit.update(lateralError, std::hypot(speed.x, speed.y));
+
+        // get output from PIDs
+        float lateralOut = lateralPID.update(lateralError);
+        float angularOut = angularPID.update(lemlib::radToDeg(angularError));
+        if (close) angularOut = 0;
+
+        // apply restrictions on angular speed
+        angularOut = std::clamp(angularOut, -params.maxSpeed, params.maxSpeed);
+        angularOut = lemlib::slew(angularOut, prevAngularOut, angularSettings.slew);
+
+        // apply restrictions on lateral speed
+        lateralOut = std::clamp(lateralOut, -params.maxSpeed, params.maxSpeed);
+        // constrain lateral output by max accel
+        // but not for decelerating, since that would interfere with settling
+        if (!close) lateralOut = lemlib::slew(lateralOut, prevLateralOut, lateralSettings.slew);
+
+        // prevent moving in the wrong direction
+        if (params.forwards && !close) lateralOut = std::fmax(lateralOut, 0);
+        else if (!params.forwards && !close) lateralOut = std::fmin(lateralOut, 0);
+
+        // constrain lateral output by the minimum speed
+        if (params.forwards && lateralOut < std::fabs(params.minSpeed) && lateralOut > 0)
+            lateralOut = std::fabs(params.minSpeed);
+        if (!params.forwards && -lateralOut < std::fabs(params.minSpeed) && lateralOut < 0)
+            lateralOut = -std::fabs(params.minSpeed);
+
+        // update previous output
+        prevAngularOut = angularOut;
+        prevLateralOut = lateralOut;
+
+        lemlib::infoSink()->debug("Angular Out: {}, Lateral Out: {}", angularOut, lateralOut);
+
+        // ratio the speeds to respect the max speed
+        float leftPower = lateralOut + angularOut;
+        float rightPower = lateralOut - angularOut;
+        const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / params.maxSpeed;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+
+        // move the drivetrain
+        moveMotors(drivetrain.leftMotors, leftPower);
+        moveMotors(drivetrain.rightMotors, rightPower);
+
+        // delay to save resources
+        pros::delay(10);
+    }
+
+    // stop the drivetrain
+    moveMotors(drivetrain.leftMotors, 0);
+    moveMotors(drivetrain.rightMotors, 0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+}
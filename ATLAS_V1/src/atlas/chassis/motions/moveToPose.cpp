@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cmath>
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+#include "atlas/chassis/chassis.hpp"
+#include "atlas/chassis/odom.hpp"
+
+void atlas::Chassis::moveToPose(float x, float y, float theta, int timeout, lemlib::MoveToPoseParams params,
+                                bool async) {
+    // take the mutex
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([&]() { moveToPose(x, y, theta, timeout, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+
+    // reset PIDs and exit conditions
+    lateralPID.reset();
+    lateralLargeExit.reset();
+    lateralSmallExit.reset();
+    lateralSettleExit.reset();
+    angularPID.reset();
+    angularLargeExit.reset();
+    angularSmallExit.reset();
+    angularSettleExit.reset();
+
+    // calculate target pose in standard form
+    lemlib::Pose target(x, y, M_PI_2 - lemlib::degToRad(theta));
+    if (!params.forwards) target.theta = std::fmod(target.theta + M_PI, 2 * M_PI); // backwards movement
+
+    // use global horizontalDrift is horizontalDrift is 0
+    if (params.horizontalDrift == 0) params.horizontalDrift = drivetrain.horizontalDrift;
+
+    // initialize vars used between iterations
+    lemlib::Pose lastPose = getPose();
+    distTraveled = 0;
+    lemlib::Timer timer(timeout);
+    bool close = false;
+    bool lateralSettled = false;
+    bool prevSameSide = false;
+    float prevLateralOut = 0; // previous lateral power
+
+    // main loop
+    while (!timer.isDone() &&
+           ((!lateralSettled ||
+             (!angularLargeExit.getExit() && !angularSmallExit.getExit() && !angularSettleExit.getExit())) ||
+            !close) &&
+           this->motionRunning) {
+        // update position
+        const lemlib::Pose pose = getPose(true, true);
+
+        // update distance traveled
+        distTraveled += pose.distance(lastPose);
+        lastPose = pose;
+
+        // calculate distance to the target point
+        const float distTarget = pose.distance(target);
+
+        // check if the robot is close enough to the target to start settling
+        if (distTarget < 7.5 && close == false) {
+            close = true;
+            params.maxSpeed = std::fmax(std::fabs(prevLateralOut), 60);
+        }
+
+        // check if the lateral controller has settled
+        if ((lateralLargeExit.getExit() && lateralSmallExit.getExit()) || lateralSettleExit.getExit())
+            lateralSettled = true;
+
+        // calculate the carrot point
+        lemlib::Pose carrot =
+            target - lemlib::Pose(std::cos(target.theta), std::sin(target.theta)) * params.lead * distTarget;
+        if (close) carrot = target; // settling behavior
+
+        // calculate if the robot is on the same side as the carrot point
+        const bool robotSide = (pose.y - target.y) * -std::sin(target.theta) <=
+                               (pose.x - target.x) * std::cos(target.theta) + params.earlyExitRange;
+        const bool carrotSide = (carrot.y - target.y) * -std::sin(target.theta) <=
+                                (carrot.x - target.x) * std::cos(target.theta) + params.earlyExitRange;
+        const bool sameSide = robotSide == carrotSide;
+        // exit if close
+        if (!sameSide && prevSameSide && close && params.minSpeed != 0) break;
+        prevSameSide = sameSide;
+
+        // calculate error
+        const float adjustedRobotTheta = params.forwards ? pose.theta : pose.theta + M_PI;
+        const float angularError = close ? lemlib::angleError(adjustedRobotTheta, target.theta)
+                                         : lemlib::angleError(adjustedRobotTheta, pose.angle(carrot));
+        float lateralError = pose.distance(carrot);
+        // only use cos when settling
+        // otherwise just multiply by the sign of cos
+        // maxSlipSpeed takes care of lateralOut
+        if (close) lateralError *= std::cos(lemlib::angleError(pose.theta, pose.angle(carrot)));
+        else lateralError *= lemlib::sgn(std::cos(lemlib::angleError(pose.theta, pose.angle(carrot))));
+
+        // update exit conditions
+        const lemlib::Pose speed = atlas::getLocalSpeed();
+        lateralSmallExit.update(lateralError);
+        lateralLargeExit.update(lateralError);
+        lateralSettleExit.update(lateralError, std::hypot(speed.x, speed.y));
+        angularSmallExit.update(lemlib::radToDeg(angularError));
+        angularLargeExit.update(lemlib::radToDeg(angularError));
+        angularSettleExit.update(lemlib::radToDeg(angularError), speed.theta);
+
+        // get output from PIDs
+        float lateralOut = lateralPID.update(lateralError);
+        float angularOut = angularPID.update(lemlib::radToDeg(angularError));
+
+        // apply restrictions on angular speed
+        angularOut = std::clamp(angularOut, -params.maxSpeed, params.maxSpeed);
+
+        // apply restrictions on lateral speed
+        lateralOut = std::clamp(lateralOut, -params.maxSpeed, params.maxSpeed);
+
+        // constrain lateral output by max accel
+        if (!close) lateralOut = lemlib::slew(lateralOut, prevLateralOut, lateralSettings.slew);
+
+        // constrain lateral output by the max speed it can travel at without
+        // slipping
+        const float radius = 1 / std::fabs(lemlib::getCurvature(pose, carrot));
+        const float maxSlipSpeed(std::sqrt(params.horizontalDrift * radius * 9.8));
+        lateralOut = std::clamp(lateralOut, -maxSlipSpeed, maxSlipSpeed);
+        // prioritize angular movement over lateral movement
+        const float overturn = std::fabs(angularOut) + std::fabs(lateralOut) - params.maxSpeed;
+        if (overturn > 0) lateralOut -= lateralOut > 0 ? overturn : -overturn;
+
+        // prevent moving in the wrong direction
+        if (params.forwards && !close) lateralOut = std::fmax(lateralOut, 0);
+        else if (!params.forwards && !close) lateralOut = std::fmin(lateralOut, 0);
+
+        // constrain lateral output by the minimum speed
+        if (params.forwards && lateralOut < std::fabs(params.minSpeed) && lateralOut > 0)
+            lateralOut = std::fabs(params.minSpeed);
+        if (!params.forwards && -lateralOut < std::fabs(params.minSpeed) && lateralOut < 0)
+            lateralOut = -std::fabs(params.minSpeed);
+
+        // update previous output
+        prevLateralOut = lateralOut;
+
+        lemlib::infoSink()->debug("lateralOut: {} angularOut: {}", lateralOut, angularOut);
+
+        // ratio the speeds to respect the max speed
+        float leftPower = lateralOut + angularOut;
+        float rightPower = lateralOut - angularOut;
+        const float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / params.maxSpeed;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+
+        // move the drivetrain
+        moveMotors(drivetrain.leftMotors, leftPower);
+        moveMotors(drivetrain.rightMotors, rightPower);
+
+        // delay to save resources
+        pros::delay(10);
+    }
+
+    // stop the drivetrain
+    moveMotors(drivetrain.leftMotors, 0);
+    moveMotors(drivetrain.rightMotors, 0);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+}
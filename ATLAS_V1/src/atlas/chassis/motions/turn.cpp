@@ -0,0 +1,216 @@
+#include <cmath>
+#include <optional>
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+#include "atlas/chassis/chassis.hpp"
+#include "atlas/chassis/odom.hpp"
+
+/**
+ * @brief Get the heading that faces a point
+ *
+ * @param pose the pose of the robot
+ * @param point the point to face
+ * @param forwards whether the front of the robot faces the point, rather than the back
+ * @return float the heading, in degrees
+ */
+static float headingTo(lemlib::Pose pose, lemlib::Pose point, bool forwards) {
+    const float heading = lemlib::radToDeg(M_PI_2 - pose.angle(point));
+    return forwards ? heading : heading + 180;
+}
+
+void atlas::Chassis::turnToHeading(float theta, int timeout, TurnToHeadingParams params, bool async) {
+    // take the mutex
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([&]() { turnToHeading(theta, timeout, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+    headingMotion(theta, std::nullopt, timeout,
+                  {params.direction, float(params.maxSpeed), float(params.minSpeed), params.earlyExitRange,
+                   params.profiled});
+}
+
+void atlas::Chassis::swingToHeading(float theta, lemlib::DriveSide lockedSide, int timeout,
+                                    SwingToHeadingParams params, bool async) {
+    // take the mutex
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([&]() { swingToHeading(theta, lockedSide, timeout, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+    headingMotion(theta, lockedSide, timeout, params);
+}
+
+void atlas::Chassis::turnToPoint(float x, float y, int timeout, lemlib::TurnToPointParams params, bool async) {
+    // take the mutex
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([&]() { turnToPoint(x, y, timeout, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+    const lemlib::Pose point(x, y);
+    headingMotion(headingTo(getPose(), point, params.forwards), std::nullopt, timeout,
+                  {params.direction, float(params.maxSpeed), float(params.minSpeed), params.earlyExitRange},
+                  point, params.forwards);
+}
+
+void atlas::Chassis::swingToPoint(float x, float y, lemlib::DriveSide lockedSide, int timeout,
+                                  lemlib::SwingToPointParams params, bool async) {
+    // take the mutex
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return;
+    // if the function is async, run it in a new task
+    if (async) {
+        pros::Task task([&]() { swingToPoint(x, y, lockedSide, timeout, params, false); });
+        this->endMotion();
+        pros::delay(10); // delay to give the task time to start
+        return;
+    }
+    const lemlib::Pose point(x, y);
+    headingMotion(headingTo(getPose(), point, params.forwards), lockedSide, timeout,
+                  {params.direction, params.maxSpeed, params.minSpeed, params.earlyExitRange}, point,
+                  params.forwards);
+}
+
+void atlas::Chassis::headingMotion(float theta, std::optional<lemlib::DriveSide> lockedSide, int timeout,
+                                   SwingToHeadingParams params, std::optional<lemlib::Pose> point, bool forwards) {
+    float deltaTheta;
+    float motorPower;
+    std::optional<float> prevRawDeltaTheta = std::nullopt;
+    std::optional<float> prevDeltaTheta = std::nullopt;
+    float prevMotorPower = 0;
+    const float startTheta = getPose().theta;
+    bool settling = false;
+    distTraveled = 0;
+    lemlib::Timer timer(timeout);
+    angularLargeExit.reset();
+    angularSmallExit.reset();
+    angularSettleExit.reset();
+    angularPID.reset();
+
+    // theoretical max angular velocity, in deg/s
+    // a swing pivots around the locked side, so the moving side is twice as far from the center of rotation
+    const float wheelSpeed = drivetrain.rpm / 60 * M_PI * drivetrain.wheelDiameter;
+    const float pivotRadius = lockedSide ? drivetrain.trackWidth : drivetrain.trackWidth / 2;
+    const float maxAngularVel = lemlib::radToDeg(wheelSpeed / pivotRadius);
+    // feedforward gain, maps angular velocity to motor power
+    const float kV = 127 / maxAngularVel;
+
+    // plan the profile from the current heading and angular velocity
+    const float distance = lemlib::angleError(theta, startTheta, false, params.direction);
+    const float direction = lemlib::sgn(distance);
+    const float cruiseVel = angularProfile.speedRatio * maxAngularVel * std::fabs(params.maxSpeed) / 127;
+    const float accel = angularProfile.speedRatio * maxAngularVel / angularProfile.accelTime;
+    const float startVel = std::fmax(direction * atlas::getLocalSpeed().theta, 0);
+    const float endVel = maxAngularVel * std::fabs(params.minSpeed) / 127;
+    const TrapezoidalProfile profile(distance, cruiseVel, accel, startVel, endVel);
+    const int startTime = pros::millis();
+
+    // hold the locked side in place while swinging
+    pros::MotorGroup* lockedMotors = nullptr;
+    pros::MotorGroup* swingMotors = nullptr;
+    if (lockedSide == lemlib::DriveSide::LEFT) {
+        lockedMotors = drivetrain.leftMotors;
+        swingMotors = drivetrain.rightMotors;
+    } else if (lockedSide == lemlib::DriveSide::RIGHT) {
+        lockedMotors = drivetrain.rightMotors;
+        swingMotors = drivetrain.leftMotors;
+    }
+    const pros::MotorBrake brakeMode = lockedMotors ? lockedMotors->get_brake_mode() : pros::MotorBrake::coast;
+    if (lockedMotors) lockedMotors->set_brake_mode_all(pros::MotorBrake::hold);
+
+    // main loop
+    while (!timer.isDone() && !angularLargeExit.getExit() && !angularSmallExit.getExit() &&
+           !angularSettleExit.getExit() && this->motionRunning) {
+        // update variables
+        const lemlib::Pose pose = getPose();
+        const float time = (pros::millis() - startTime) / 1000.0;
+        if (point) theta = headingTo(pose, *point, forwards);
+
+        // update completion vars
+        distTraveled = std::fabs(lemlib::angleError(pose.theta, startTheta, false));
+
+        // check if settling
+        const float rawDeltaTheta = lemlib::angleError(theta, pose.theta, false);
+        if (prevRawDeltaTheta == std::nullopt) prevRawDeltaTheta = rawDeltaTheta;
+        if (lemlib::sgn(rawDeltaTheta) != lemlib::sgn(*prevRawDeltaTheta)) settling = true;
+        prevRawDeltaTheta = rawDeltaTheta;
+
+        // calculate deltaTheta
+        if (settling) deltaTheta = lemlib::angleError(theta, pose.theta, false);
+        else deltaTheta = lemlib::angleError(theta, pose.theta, false, params.direction);
+        if (prevDeltaTheta == std::nullopt) prevDeltaTheta = deltaTheta;
+
+        // motion chaining
+        if (params.minSpeed != 0 && std::fabs(deltaTheta) < params.earlyExitRange) break;
+        if (params.minSpeed != 0 && lemlib::sgn(deltaTheta) != lemlib::sgn(*prevDeltaTheta)) break;
+        prevDeltaTheta = deltaTheta;
+
+        // update exit conditions
+        angularLargeExit.update(deltaTheta);
+        angularSmallExit.update(deltaTheta);
+        angularSettleExit.update(deltaTheta, atlas::getLocalSpeed().theta);
+
+        // calculate the speed
+        if (params.profiled && time < profile.getDuration()) {
+            // feedforward from the profile, PID only corrects the residual from the profiled heading
+            const ProfileState state = profile.sample(time);
+            const float residual = lemlib::angleError(startTheta + direction * state.position, pose.theta, false);
+            motorPower = direction * (state.velocity * kV + state.acceleration * angularProfile.kA) +
+                         angularPID.update(residual);
+        } else {
+            motorPower = angularPID.update(deltaTheta);
+            if (!params.profiled && std::fabs(deltaTheta) > 20)
+                motorPower = lemlib::slew(motorPower, prevMotorPower, angularSettings.slew);
+        }
+
+        // cap the speed
+        if (motorPower > params.maxSpeed) motorPower = params.maxSpeed;
+        else if (motorPower < -params.maxSpeed) motorPower = -params.maxSpeed;
+        if (motorPower < 0 && motorPower > -params.minSpeed) motorPower = -params.minSpeed;
+        else if (motorPower > 0 && motorPower < params.minSpeed) motorPower = params.minSpeed;
+        prevMotorPower = motorPower;
+
+        lemlib::infoSink()->debug("Turn Motor Power: {} ", motorPower);
+
+        // move the drivetrain
+        if (lockedSide == lemlib::DriveSide::LEFT) {
+            moveMotors(swingMotors, -motorPower);
+            lockedMotors->brake();
+        } else if (lockedSide == lemlib::DriveSide::RIGHT) {
+            moveMotors(swingMotors, motorPower);
+            lockedMotors->brake();
+        } else {
+            moveMotors(drivetrain.leftMotors, motorPower);
+            moveMotors(drivetrain.rightMotors, -motorPower);
+        }
+
+        pros::delay(10);
+    }
+
+    // stop the drivetrain
+    moveMotors(drivetrain.leftMotors, 0);
+    moveMotors(drivetrain.rightMotors, 0);
+    // restore the brake mode of the locked side
+    if (lockedMotors) lockedMotors->set_brake_mode_all(brakeMode);
+    // set distTraveled to -1 to indicate that the function has finished
+    distTraveled = -1;
+    this->endMotion();
+}
@@ -0,0 +1,584 @@
+// The motion model is the same as LemLib odometry, which uses the "arc" method described in the
+// document below, optionally with a second order Magnus expansion term for motion that changes
+// within an update. The result is then used to predict an extended Kalman filter, which is corrected
+// with the GPS and the distance sensors whenever they have a new reading
+// https://www.vexforum.com/t/tracking-wheel-odometry-explained/103813
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "pros/error.h"
+#include "pros/rotation.hpp"
+#include "pros/rtos.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/util.hpp"
+#include "atlas/chassis/odom.hpp"
+#include "atlas/ekf.hpp"
+
+// variance added per inch traveled. Tracking wheels drift about an inch every 100 inches
+constexpr float TRANSLATION_NOISE = 0.01;
+// variance added per radian turned
+constexpr float ROTATION_NOISE = 0.001;
+// heading variance added every update, from IMU drift left over after the bias is removed
+constexpr float DRIFT_NOISE = 1e-7;
+// standard deviation of the GPS heading, in radians
+constexpr float GPS_HEADING_STDEV = lemlib::degToRad(1.5);
+// the GPS can't report an error smaller than this, in inches
+constexpr float GPS_MIN_STDEV = 0.25;
+// GPS readings further than this squared Mahalanobis distance from the estimate are rejected.
+// 99% chi-square for 3 degrees of freedom
+constexpr float GPS_GATE = 11.34;
+constexpr float METERS_TO_INCHES = 39.3701;
+// a GPS reading describes where the robot was this long before it is read, in microseconds
+constexpr std::uint64_t GPS_LATENCY = 30000;
+// number of poses kept to look up where the robot was when a delayed reading was taken. 0.5s at the odometry rate
+constexpr int POSE_HISTORY = 50;
+// how often odometry updates, in ms
+constexpr std::uint32_t ODOM_PERIOD = 10;
+// sensors send new data twice every update, so every update has a fresh reading, in ms
+constexpr std::uint32_t SENSOR_DATA_RATE = ODOM_PERIOD / 2;
+// longest setPose and setSensors wait for the odometry task to apply the change, in ms
+constexpr std::uint32_t RESET_TIMEOUT = 5 * ODOM_PERIOD;
+// tracking wheels moving less than this in an update count as still, in inches
+constexpr float STILL_DISTANCE = 0.002;
+// the robot has to be still for this long before the IMU drift is estimated, in ms
+constexpr float STILL_TIME = 250;
+// how fast the drift estimate follows the IMUs while the robot is still
+constexpr float BIAS_SMOOTHING = 0.02;
+// the drive motors and tracking wheels disagreeing by more than this in an update means the drive wheels are
+// slipping, in inches. About 5 in/s at the odometry rate
+constexpr float SLIP_DISTANCE = 0.05;
+// how much the drive motors are trusted over the tracking wheels while they agree
+constexpr float MOTOR_WEIGHT = 0.2;
+// a tracking wheel moving further than this in one update is broken, in inches
+constexpr float MAX_WHEEL_STEP = 2;
+// an unplugged rotation sensor reports PROS_ERR, which is further than any match could travel, in inches
+constexpr float MAX_WHEEL_DISTANCE = 100000;
+
+// LemLib odometry defines the same names, so these are kept local to this file
+
+// tracking thread
+static pros::Task* trackingTask = nullptr;
+
+// global variables
+static atlas::OdomSensors odomSensors(nullptr, nullptr, nullptr, nullptr, nullptr); // the sensors to be used
+static lemlib::Drivetrain drivetrain(nullptr, nullptr, 0, 0, 0, 0); // the drivetrain to be used
+static atlas::Ekf ekf(TRANSLATION_NOISE, ROTATION_NOISE, DRIFT_NOISE); // the pose estimate
+static lemlib::Pose odomPose(0, 0, 0); // the pose from the tracking wheels and IMU alone
+static lemlib::Pose odomSpeed(0, 0, 0); // the speed of the robot
+static lemlib::Pose odomLocalSpeed(0, 0, 0); // the local speed of the robot
+
+static std::uint64_t prevTime = 0;
+static float prevVertical1 = 0;
+static float prevVertical2 = 0;
+static float prevHorizontal1 = 0;
+static float prevHorizontal2 = 0;
+static lemlib::TrackingWheel* leftDrive = nullptr; // the drive motors, to check the tracking wheels against
+static lemlib::TrackingWheel* rightDrive = nullptr;
+// drive wheels made here when calibrate didn't substitute one. Made once, so recalibrating doesn't leak them
+static std::unique_ptr<lemlib::TrackingWheel> ownedLeftDrive;
+static std::unique_ptr<lemlib::TrackingWheel> ownedRightDrive;
+static float prevLeftDrive = NAN;
+static float prevRightDrive = NAN;
+static float slip = 0; // smoothed disagreement between the drive motors and tracking wheels, in inches per update
+static bool wheelFailed = false;
+static atlas::Integration integration = atlas::Integration::ARC;
+static lemlib::Pose prevArc(0, 0, 0); // motion of the tracking center in the previous update
+static std::vector<double> imuReadings; // sized when the sensors are set, so reading them never allocates
+static std::vector<float> prevImus; // NaN until the IMU has a reading
+static std::vector<float> imuBiases; // drift of each IMU per update, in radians
+static float stillTime = 0;
+static pros::gps_status_s_t prevGps = {0, 0, 0, 0, 0};
+
+/**
+ * @brief An uncorrected pose, and when it was measured
+ */
+struct PoseSample {
+        std::uint64_t time = 0; // in microseconds, from pros::micros
+        lemlib::Pose pose = {0, 0, 0};
+};
+
+static std::array<PoseSample, POSE_HISTORY> poseHistory; // ring buffer, the oldest sample is overwritten
+static int historyHead = 0; // index the next sample is written to
+static int historySize = 0;
+
+// corrections, resets and sensor changes from other tasks, applied on the next update
+static pros::Mutex correctionMutex;
+static std::optional<std::pair<lemlib::Pose, lemlib::Pose>> pendingCorrection;
+static std::optional<lemlib::Pose> pendingReset;
+static std::optional<std::pair<atlas::OdomSensors, lemlib::Drivetrain>> pendingSensors;
+
+/**
+ * @brief Wait for the odometry task to apply a pending change, so the caller sees it once this returns
+ *
+ * @param pending the pending change, which the odometry task clears once it is applied
+ */
+template <typename T> static void waitUntilApplied(const std::optional<T>& pending) {
+    const std::uint32_t start = pros::millis();
+    while (pros::millis() - start < RESET_TIMEOUT) {
+        {
+            std::lock_guard<pros::Mutex> lock(correctionMutex);
+            if (!pending) return;
+        }
+        pros::delay(1);
+    }
+}
+
+/**
+ * @brief Move the estimate to a pose, forgetting everything measured before it
+ *
+ * @param pose the new pose, theta in radians
+ */
+static void resetPose(lemlib::Pose pose) {
+    ekf.reset(pose);
+    odomPose = pose;
+    // the uncorrected pose jumped, so motion can't be measured across it
+    historySize = 0;
+    lemlib::setPose(pose, true);
+}
+
+/**
+ * @brief Switch odometry to new sensors
+ *
+ * @param sensors the sensors
+ * @param drivetrain the drivetrain
+ */
+static void applySensors(const atlas::OdomSensors& sensors, const lemlib::Drivetrain& drivetrain) {
+    odomSensors = sensors;
+    ::drivetrain = drivetrain;
+    imuReadings.assign(sensors.imus.size(), 0);
+    prevImus.assign(sensors.imus.size(), NAN);
+    imuBiases.assign(sensors.imus.size(), 0);
+    stillTime = 0;
+    // reuse the drivetrain wheels calibrate substituted for missing vertical wheels, so no motor is read twice
+    if (sensors.vertical1 != nullptr && sensors.vertical1->getType()) leftDrive = sensors.vertical1;
+    else if (drivetrain.leftMotors != nullptr) {
+        if (ownedLeftDrive == nullptr)
+            ownedLeftDrive = std::make_unique<lemlib::TrackingWheel>(drivetrain.leftMotors, drivetrain.wheelDiameter,
+                                                                     -(drivetrain.trackWidth / 2), drivetrain.rpm);
+        leftDrive = ownedLeftDrive.get();
+    } else leftDrive = nullptr;
+    if (sensors.vertical2 != nullptr && sensors.vertical2->getType()) rightDrive = sensors.vertical2;
+    else if (drivetrain.rightMotors != nullptr) {
+        if (ownedRightDrive == nullptr)
+            ownedRightDrive = std::make_unique<lemlib::TrackingWheel>(drivetrain.rightMotors, drivetrain.wheelDiameter,
+                                                                      drivetrain.trackWidth / 2, drivetrain.rpm);
+        rightDrive = ownedRightDrive.get();
+    } else rightDrive = nullptr;
+    prevLeftDrive = NAN;
+    prevRightDrive = NAN;
+    slip = 0;
+    wheelFailed = false;
+    // send sensor data as often as odometry uses it. LemLib tracking wheels don't expose their sensors, so every
+    // rotation sensor on the robot is configured
+    for (pros::Imu* imu : sensors.imus) imu->set_data_rate(SENSOR_DATA_RATE);
+    for (pros::Rotation& rotation : pros::Rotation::get_all_devices()) rotation.set_data_rate(SENSOR_DATA_RATE);
+}
+
+void atlas::setSensors(OdomSensors sensors, lemlib::Drivetrain drivetrain) {
+    {
+        std::lock_guard<pros::Mutex> lock(correctionMutex);
+        // without the odometry task, nothing else reads the sensors
+        if (trackingTask == nullptr) {
+            applySensors(sensors, drivetrain);
+            return;
+        }
+        // recalibrating while odometry runs, so let the odometry task switch between updates
+        pendingSensors = {sensors, drivetrain};
+    }
+    waitUntilApplied(pendingSensors);
+}
+
+lemlib::Pose atlas::getPose(bool radians) {
+    lemlib::Pose pose = ekf.getPose();
+    if (!radians) pose.theta = lemlib::radToDeg(pose.theta);
+    return pose;
+}
+
+void atlas::setPose(lemlib::Pose pose, bool radians) {
+    if (!radians) pose.theta = lemlib::degToRad(pose.theta);
+    {
+        std::lock_guard<pros::Mutex> lock(correctionMutex);
+        // a correction measured before the reset is in the old frame
+        pendingCorrection.reset();
+        // without the odometry task, nothing else touches the estimate
+        if (trackingTask == nullptr) {
+            resetPose(pose);
+            return;
+        }
+        pendingReset = pose;
+    }
+    // motions read the pose right after setting it, so wait for the odometry task to take it
+    waitUntilApplied(pendingReset);
+}
+
+void atlas::correctPose(lemlib::Pose pose, lemlib::Pose variance) {
+    std::lock_guard<pros::Mutex> lock(correctionMutex);
+    pendingCorrection = {pose, variance};
+}
+
+void atlas::setIntegration(Integration integration) { ::integration = integration; }
+
+lemlib::Pose atlas::getOdomPose(bool radians) {
+    if (radians) return odomPose;
+    else return lemlib::Pose(odomPose.x, odomPose.y, lemlib::radToDeg(odomPose.theta));
+}
+
+lemlib::Pose atlas::getSpeed(bool radians) {
+    if (radians) return odomSpeed;
+    else return lemlib::Pose(odomSpeed.x, odomSpeed.y, lemlib::radToDeg(odomSpeed.theta));
+}
+
+lemlib::Pose atlas::getLocalSpeed(bool radians) {
+    if (radians) return odomLocalSpeed;
+    else return lemlib::Pose(odomLocalSpeed.x, odomLocalSpeed.y, lemlib::radToDeg(odomLocalSpeed.theta));
+}
+
+/**
+ * @brief Record the uncorrected pose in the history
+ *
+ * @param time when the pose was measured, in microseconds
+ */
+static void recordPose(std::uint64_t time) {
+    poseHistory[historyHead] = {time, odomPose};
+    historyHead = (historyHead + 1) % POSE_HISTORY;
+    historySize = std::min(historySize + 1, POSE_HISTORY);
+}
+
+/**
+ * @brief Get the uncorrected pose at a past time, interpolating between samples
+ *
+ * @param time the time, in microseconds
+ * @return lemlib::Pose the pose, theta in radians. The oldest pose if the time is before the history, and the current
+ * pose if there is no history
+ */
+static lemlib::Pose poseAt(std::uint64_t time) {
+    if (historySize == 0) return odomPose;
+    // walk back from the newest sample
+    const PoseSample* newer = nullptr;
+    for (int i = 1; i <= historySize; i++) {
+        const PoseSample& sample = poseHistory[(historyHead - i + POSE_HISTORY) % POSE_HISTORY];
+        if (sample.time <= time) {
+            if (newer == nullptr) return sample.pose;
+            const float t = float(time - sample.time) / (newer->time - sample.time);
+            return {sample.pose.x + (newer->pose.x - sample.pose.x) * t,
+                    sample.pose.y + (newer->pose.y - sample.pose.y) * t,
+                    sample.pose.theta + (newer->pose.theta - sample.pose.theta) * t};
+        }
+        newer = &sample;
+    }
+    return newer->pose;
+}
+
+/**
+ * @brief Correct the pose estimate with the GPS, if it has a new reading
+ *
+ * The reading is where the robot was GPS_LATENCY ago, so it is moved forward by the motion odometry measured since
+ * then, and corrects the current pose without a jump.
+ */
+static void correctGps(std::uint64_t time) {
+    if (odomSensors.gps == nullptr) return;
+    const pros::gps_status_s_t gps = odomSensors.gps->get_position_and_orientation();
+    const float error = odomSensors.gps->get_error();
+    if (gps.x == PROS_ERR_F || error == PROS_ERR_F) return;
+    // the GPS updates slower than odometry, so don't fuse the same reading twice
+    if (gps.x == prevGps.x && gps.y == prevGps.y && gps.yaw == prevGps.yaw) return;
+    prevGps = gps;
+
+    // the GPS measures the pose directly, in meters and degrees
+    lemlib::Pose measured(gps.x * METERS_TO_INCHES, gps.y * METERS_TO_INCHES, lemlib::degToRad(gps.yaw));
+    // move the reading by how far the robot moved since it was taken, turned to match the GPS heading
+    const lemlib::Pose past = poseAt(time - std::min(time, GPS_LATENCY));
+    const lemlib::Pose moved = (odomPose - past).rotate(past.theta - measured.theta);
+    measured = measured + moved;
+    const lemlib::Pose pose = ekf.getPose();
+    const atlas::Matrix<3, 1> innovation = {measured.x - pose.x, measured.y - pose.y,
+                                            lemlib::angleError(measured.theta, pose.theta)};
+    const float positionVar = std::pow(std::fmax(error * METERS_TO_INCHES, GPS_MIN_STDEV), 2);
+    const atlas::Matrix<3, 3> R = {positionVar, 0, 0,
+                                   0, positionVar, 0,
+                                   0, 0, GPS_HEADING_STDEV * GPS_HEADING_STDEV};
+    ekf.correct(innovation, atlas::Matrix<3, 3>::identity(), R, GPS_GATE);
+}
+
+/**
+ * @brief Fuse a correction from another task, if there is one
+ */
+static void correctPending() {
+    std::optional<std::pair<lemlib::Pose, lemlib::Pose>> correction;
+    {
+        std::lock_guard<pros::Mutex> lock(correctionMutex);
+        correction.swap(pendingCorrection);
+    }
+    if (!correction) return;
+    const auto& [pose, variance] = *correction;
+    const lemlib::Pose estimate = ekf.getPose();
+    const atlas::Matrix<3, 1> innovation = {pose.x - estimate.x, pose.y - estimate.y,
+                                            lemlib::angleError(pose.theta, estimate.theta)};
+    const atlas::Matrix<3, 3> R = {variance.x, 0, 0,
+                                   0, variance.y, 0,
+                                   0, 0, variance.theta};
+    // the estimate is trusted as given, so it isn't gated
+    ekf.correct(innovation, atlas::Matrix<3, 3>::identity(), R, INFINITY);
+}
+
+/**
+ * @brief Every tracking wheel reading odometry needs for an update
+ */
+struct SensorSnapshot {
+        /** when the sensors were read, in microseconds */
+        std::uint64_t time = 0;
+        float vertical1 = 0;
+        float vertical2 = 0;
+        float horizontal1 = 0;
+        float horizontal2 = 0;
+        float leftDrive = NAN;
+        float rightDrive = NAN;
+};
+
+/**
+ * @brief Read every sensor once, back to back, so all the readings are from the same moment
+ *
+ * The IMU readings are stored in imuReadings.
+ *
+ * @return SensorSnapshot the tracking wheel readings
+ */
+static SensorSnapshot readSensors() {
+    SensorSnapshot snapshot;
+    snapshot.time = pros::micros();
+    if (odomSensors.vertical1 != nullptr) snapshot.vertical1 = odomSensors.vertical1->getDistanceTraveled();
+    if (odomSensors.vertical2 != nullptr) snapshot.vertical2 = odomSensors.vertical2->getDistanceTraveled();
+    if (odomSensors.horizontal1 != nullptr) snapshot.horizontal1 = odomSensors.horizontal1->getDistanceTraveled();
+    if (odomSensors.horizontal2 != nullptr) snapshot.horizontal2 = odomSensors.horizontal2->getDistanceTraveled();
+    if (leftDrive == odomSensors.vertical1) snapshot.leftDrive = snapshot.vertical1;
+    else if (leftDrive != nullptr) snapshot.leftDrive = leftDrive->getDistanceTraveled();
+    if (rightDrive == odomSensors.vertical2) snapshot.rightDrive = snapshot.vertical2;
+    else if (rightDrive != nullptr) snapshot.rightDrive = rightDrive->getDistanceTraveled();
+    for (int i = 0; i < int(odomSensors.imus.size()); i++) imuReadings[i] = odomSensors.imus[i]->get_rotation();
+    return snapshot;
+}
+
+/**
+ * @brief Get the change in heading measured by the IMUs
+ *
+ * @param still whether the tracking wheels show the robot is still
+ * @return std::optional<float> average change in heading of the working IMUs with their drift removed, in radians.
+ * std::nullopt if no IMU is working
+ */
+static std::optional<float> imuDeltaHeading(bool still) {
+    float sum = 0;
+    int count = 0;
+    for (int i = 0; i < int(odomSensors.imus.size()); i++) {
+        const double rotation = imuReadings[i];
+        // skip IMUs that are unplugged, and start over when they come back
+        if (rotation == PROS_ERR_F || std::isinf(rotation)) {
+            prevImus[i] = NAN;
+            continue;
+        }
+        const float raw = lemlib::degToRad(rotation);
+        const float delta = raw - prevImus[i];
+        prevImus[i] = raw;
+        if (std::isnan(delta)) continue;
+        // while the robot is still, everything the IMU measures is drift
+        if (still) imuBiases[i] = lemlib::ema(delta, imuBiases[i], BIAS_SMOOTHING);
+        sum += delta - imuBiases[i];
+        count++;
+    }
+    if (count == 0) return std::nullopt;
+    // the robot isn't turning, so don't integrate what is left of the drift either
+    if (still) return 0;
+    return sum / count;
+}
+
+/**
+ * @brief Integrate the motion of the tracking center over an update
+ *
+ * The arc lengths are the integral of the robot's local velocity over the update. Their exponential in SE(2) is the
+ * chord of a constant curvature arc, which is LemLib's arc method. The Magnus term corrects for the velocity changing
+ * within the update, assuming it changes linearly at the rate it changed between the last two updates.
+ *
+ * @param arc distance traveled along the arc sideways and forwards in inches, and change in heading in radians
+ * @return lemlib::Pose straight line motion relative to the heading halfway through the update, and the change in
+ * heading
+ */
+static lemlib::Pose integrate(lemlib::Pose arc) {
+    lemlib::Pose motion = arc;
+    if (integration == atlas::Integration::MAGNUS) {
+        const lemlib::Pose change = arc - prevArc;
+        motion.x += (change.theta * arc.y - arc.theta * change.y) / 12;
+        motion.y += (arc.theta * change.x - change.theta * arc.x) / 12;
+    }
+    prevArc = arc;
+    // the chord is 2 sin(theta / 2) / theta times the arc length
+    const float chord = arc.theta == 0 ? 1 : 2 * std::sin(arc.theta / 2) / arc.theta;
+    return {motion.x * chord, motion.y * chord, arc.theta};
+}
+
+void atlas::update() {
+    // apply sensors and a pose set from other tasks. Done under the lock, so the setters return once they are applied
+    {
+        std::lock_guard<pros::Mutex> lock(correctionMutex);
+        if (pendingSensors) applySensors(pendingSensors->first, pendingSensors->second);
+        pendingSensors.reset();
+        if (pendingReset) resetPose(*pendingReset);
+        pendingReset.reset();
+    }
+
+    // get the current sensor values
+    const SensorSnapshot snapshot = readSensors();
+    // time since the last update. Measured, so the speeds stay right if an update runs late
+    float dt = (snapshot.time - prevTime) / 1000000.0;
+    if (prevTime == 0 || dt <= 0) dt = ODOM_PERIOD / 1000.0;
+    prevTime = snapshot.time;
+
+    // calculate the change in sensor values
+    float deltaVertical1 = snapshot.vertical1 - prevVertical1;
+    float deltaVertical2 = snapshot.vertical2 - prevVertical2;
+    float deltaHorizontal1 = snapshot.horizontal1 - prevHorizontal1;
+    float deltaHorizontal2 = snapshot.horizontal2 - prevHorizontal2;
+
+    // update the previous sensor values
+    prevVertical1 = snapshot.vertical1;
+    prevVertical2 = snapshot.vertical2;
+    prevHorizontal1 = snapshot.horizontal1;
+    prevHorizontal2 = snapshot.horizontal2;
+    // NaN until both drive sides have been read twice
+    const float motorForward = (snapshot.leftDrive - prevLeftDrive + snapshot.rightDrive - prevRightDrive) / 2;
+    prevLeftDrive = snapshot.leftDrive;
+    prevRightDrive = snapshot.rightDrive;
+
+    // the IMUs can only be trusted to be still when every tracking wheel is
+    const bool moving = std::fabs(deltaVertical1) > STILL_DISTANCE || std::fabs(deltaVertical2) > STILL_DISTANCE ||
+                        std::fabs(deltaHorizontal1) > STILL_DISTANCE || std::fabs(deltaHorizontal2) > STILL_DISTANCE;
+    stillTime = moving ? 0 : stillTime + dt * 1000;
+    const std::optional<float> deltaImu = imuDeltaHeading(stillTime >= STILL_TIME);
+
+    // calculate the change in heading of the robot
+    // Priority:
+    // 1. Horizontal tracking wheels
+    // 2. Vertical tracking wheels
+    // 3. Inertial Sensor
+    // 4. Drivetrain
+    float deltaHeading = 0;
+    // calculate the heading using the horizontal tracking wheels
+    if (odomSensors.horizontal1 != nullptr && odomSensors.horizontal2 != nullptr)
+        deltaHeading = -(deltaHorizontal1 - deltaHorizontal2) /
+                       (odomSensors.horizontal1->getOffset() - odomSensors.horizontal2->getOffset());
+    // else, if both vertical tracking wheels aren't substituted by the drivetrain, use the vertical tracking wheels
+    else if (!odomSensors.vertical1->getType() && !odomSensors.vertical2->getType())
+        deltaHeading = -(deltaVertical1 - deltaVertical2) /
+                       (odomSensors.vertical1->getOffset() - odomSensors.vertical2->getOffset());
+    // else, if the inertial sensor exists, use it
+    else if (deltaImu) deltaHeading = *deltaImu;
+    // else, use the the substituted tracking wheels
+    else
+        deltaHeading = -(deltaVertical1 - deltaVertical2) /
+                       (odomSensors.vertical1->getOffset() - odomSensors.vertical2->getOffset());
+
+    // choose tracking wheels to use
+    // Prioritize non-powered tracking wheels. Their readings were already taken, so no wheel is read twice
+    float deltaX = 0;
+    float deltaY = 0;
+    float horizontalOffset = 0;
+    float verticalOffset = 0;
+    lemlib::TrackingWheel* verticalWheel =
+        !odomSensors.vertical1->getType() || odomSensors.vertical2->getType() ? odomSensors.vertical1
+                                                                              : odomSensors.vertical2;
+    deltaY = verticalWheel == odomSensors.vertical1 ? deltaVertical1 : deltaVertical2;
+    verticalOffset = verticalWheel->getOffset();
+    if (odomSensors.horizontal1 != nullptr) {
+        deltaX = deltaHorizontal1;
+        horizontalOffset = odomSensors.horizontal1->getOffset();
+    } else if (odomSensors.horizontal2 != nullptr) {
+        deltaX = deltaHorizontal2;
+        horizontalOffset = odomSensors.horizontal2->getOffset();
+    }
+
+    // distance the tracking center traveled along its arc. The tracking wheels are offset from it, so they also
+    // move when the robot turns in place
+    lemlib::Pose arc(deltaX + horizontalOffset * deltaHeading, deltaY + verticalOffset * deltaHeading, deltaHeading);
+
+    // cross-check the tracking wheel against the drive motors, to catch the drive wheels slipping when pushing or
+    // being pushed, and the tracking wheel failing
+    float slipVariance = 0;
+    if (std::isfinite(motorForward) && verticalWheel->getType() == 0) {
+        const float wheelDistance =
+            verticalWheel == odomSensors.vertical1 ? snapshot.vertical1 : snapshot.vertical2;
+        const bool failed = !std::isfinite(deltaY) || std::fabs(deltaY) > MAX_WHEEL_STEP ||
+                            std::fabs(wheelDistance) > MAX_WHEEL_DISTANCE;
+        if (failed != wheelFailed) {
+            if (failed) lemlib::infoSink()->warn("Vertical tracking wheel failed, using drive motors");
+            else lemlib::infoSink()->info("Vertical tracking wheel recovered");
+        }
+        wheelFailed = failed;
+        if (failed) {
+            // the tracking wheel is unplugged or broken, so fall back to the drive motors
+            arc.y = motorForward;
+            slipVariance = SLIP_DISTANCE * SLIP_DISTANCE;
+        } else {
+            const bool wasSlipping = slip > SLIP_DISTANCE;
+            slip = lemlib::ema(std::fabs(arc.y - motorForward), slip, 0.5);
+            // the drive motors help while they agree, and are ignored as soon as they slip
+            const float motorWeight = MOTOR_WEIGHT * std::fmax(0, 1 - slip / SLIP_DISTANCE);
+            arc.y += motorWeight * (motorForward - arc.y);
+            // pushing contacts can make the tracking wheels skid too, so trust them less while it lasts
+            slipVariance = slip * slip;
+            if (wasSlipping != (slip > SLIP_DISTANCE))
+                lemlib::infoSink()->debug("Drive wheels {} slipping", wasSlipping ? "stopped" : "started");
+        }
+    }
+
+    // calculate local x and y
+    const lemlib::Pose motion = integrate(arc);
+    const float localX = motion.x;
+    const float localY = motion.y;
+
+    // track the uncorrected pose
+    const float avgHeading = odomPose.theta + deltaHeading / 2;
+    odomPose.x += localY * std::sin(avgHeading) - localX * std::cos(avgHeading);
+    odomPose.y += localY * std::cos(avgHeading) + localX * std::sin(avgHeading);
+    odomPose.theta += deltaHeading;
+
+    // move the estimate by the measured motion
+    const lemlib::Pose prevPose = ekf.getPose();
+    ekf.predict(localX, localY, deltaHeading, slipVariance);
+    const lemlib::Pose pose = ekf.getPose();
+
+    // calculate speed. Corrections aren't motion, so this is done before the GPS is fused
+    odomSpeed.x = lemlib::ema((pose.x - prevPose.x) / dt, odomSpeed.x, 0.95);
+    odomSpeed.y = lemlib::ema((pose.y - prevPose.y) / dt, odomSpeed.y, 0.95);
+    odomSpeed.theta = lemlib::ema(deltaHeading / dt, odomSpeed.theta, 0.95);
+
+    // calculate local speed
+    odomLocalSpeed.x = lemlib::ema(localX / dt, odomLocalSpeed.x, 0.95);
+    odomLocalSpeed.y = lemlib::ema(localY / dt, odomLocalSpeed.y, 0.95);
+    odomLocalSpeed.theta = lemlib::ema(deltaHeading / dt, odomLocalSpeed.theta, 0.95);
+
+    recordPose(snapshot.time);
+    correctGps(snapshot.time);
+    // relocalize against the field walls
+    for (atlas::DistanceSensor& sensor : odomSensors.distanceSensors) sensor.correct(ekf);
+    correctPending();
+
+    // LemLib odometry isn't running, so keep its pose in sync for anything that reads it
+    lemlib::setPose(ekf.getPose(), true);
+}
+
+void atlas::init() {
+    if (trackingTask == nullptr) {
+        trackingTask = new pros::Task {[=] {
+            std::uint32_t now = pros::millis();
+            while (true) {
+                update();
+                // fixed rate, so the speeds stay correct if an update takes longer than usual
+                pros::Task::delay_until(&now, ODOM_PERIOD);
+            }
+        }};
+    }
+}
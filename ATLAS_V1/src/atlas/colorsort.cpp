@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cmath>
+#include "pros/error.h"
+#include "lemlib/logger/logger.hpp"
+#include "atlas/colorsort.hpp"
+
+// how often the optical sensor measures, in ms. Short enough to see an element pass at full intake speed
+constexpr std::uint32_t INTEGRATION_TIME = 10;
+// center of each color band, in degrees
+constexpr double RED_HUE = 10;
+constexpr double BLUE_HUE = 220;
+// a hue this close to the center of a band enters it, and has to get this far away to leave it, in degrees
+constexpr double HUE_ENTER = 30;
+constexpr double HUE_EXIT = 45;
+// an element has to move this much further away than minProximity before it is gone, out of 255
+constexpr float PROXIMITY_HYSTERESIS = 20;
+// below this intake speed, there's no telling when an element will reach the redirect, in inches per second
+constexpr float MIN_SPEED = 2;
+
+/**
+ * @brief Get how far a hue is from the center of a color band
+ *
+ * @param hue the hue, in degrees
+ * @param color the color band
+ * @return double the distance around the color wheel, in degrees
+ */
+static double hueError(double hue, atlas::GameColor color) {
+    return std::fabs(std::remainder(hue - (color == atlas::GameColor::RED ? RED_HUE : BLUE_HUE), 360));
+}
+
+atlas::ColorSort::ColorSort(pros::Optical* sensor, CachedPneumatics* redirect, Intake* intake,
+                            ColorSortSettings settings)
+    : sensor(sensor),
+      redirect(redirect),
+      intake(intake),
+      settings(settings),
+      redirectExtended(redirect->isExtended()) {}
+
+void atlas::ColorSort::reject(GameColor color) { rejected = color; }
+
+atlas::GameColor atlas::ColorSort::getColor() const { return color; }
+
+void atlas::ColorSort::setRedirect(bool extended) {
+    redirectExtended = extended;
+    if (task == nullptr) redirect->set(extended);
+}
+
+void atlas::ColorSort::toggleRedirect() { setRedirect(!redirectExtended); }
+
+atlas::GameColor atlas::ColorSort::classify() {
+    const double hue = sensor->get_hue();
+    const std::int32_t proximity = sensor->get_proximity();
+    if (hue == PROS_ERR_F || proximity == PROS_ERR) return GameColor::NONE;
+    const GameColor last = color;
+    // nothing is in front of the sensor
+    const float minProximity =
+        last == GameColor::NONE ? settings.minProximity : settings.minProximity - PROXIMITY_HYSTERESIS;
+    if (proximity < minProximity) return GameColor::NONE;
+    // keep the last color until the hue is well outside it
+    if (last != GameColor::NONE && hueError(hue, last) < HUE_EXIT) return last;
+    if (hueError(hue, GameColor::RED) < HUE_ENTER) return GameColor::RED;
+    if (hueError(hue, GameColor::BLUE) < HUE_ENTER) return GameColor::BLUE;
+    return GameColor::NONE;
+}
+
+void atlas::ColorSort::schedule(std::uint32_t now) {
+    // an element only reaches the redirect while the intake feeds forwards
+    if (intake->isUnjamming()) return;
+    const double rpm = intake->getMotor()->get_actual_velocity();
+    if (rpm == PROS_ERR_F) return;
+    const float speed = rpm / 60 * M_PI * settings.rollerDiameter;
+    if (speed < MIN_SPEED) return;
+    const std::uint32_t arrival = now + std::lround(settings.distance / speed * 1000);
+    // an element right behind another keeps the redirect switched until it has passed too
+    if (ejectStart == 0) ejectStart = arrival;
+    ejectEnd = std::max(ejectEnd, std::uint32_t(arrival + settings.ejectTime));
+    lemlib::infoSink()->debug("Color sort ejecting in {} ms", arrival - now);
+}
+
+void atlas::ColorSort::start() {
+    if (task != nullptr) return;
+    sensor->set_integration_time(INTEGRATION_TIME);
+    sensor->set_led_pwm(100);
+    task = new pros::Task {[this] {
+        std::uint32_t nextRead = pros::millis();
+        while (true) {
+            std::uint32_t now = pros::millis();
+            if (now >= nextRead) {
+                const GameColor newColor = classify();
+                if (newColor != color && newColor != GameColor::NONE && newColor == rejected) schedule(now);
+                color = newColor;
+                nextRead = std::max(nextRead + INTEGRATION_TIME, now + 1);
+            }
+            // clearing a jam carries the element back past the sensor, so it won't arrive when it was expected to
+            if (!switched && ejectStart != 0 && intake->isUnjamming()) {
+                ejectStart = 0;
+                ejectEnd = 0;
+            }
+            if (!switched && ejectStart != 0 && now >= ejectStart) switched = true;
+            if (switched && now >= ejectEnd) {
+                switched = false;
+                ejectStart = 0;
+                ejectEnd = 0;
+            }
+            // an eject switches the redirect away from where it was set. Only sent when it changes
+            const bool extended = redirectExtended;
+            redirect->set(switched ? !extended : extended);
+            // sleep until the next reading or redirect switch, whichever comes first
+            std::uint32_t wake = nextRead;
+            if (!switched && ejectStart != 0) wake = std::min(wake, ejectStart);
+            if (switched) wake = std::min(wake, ejectEnd);
+            pros::Task::delay_until(&now, wake > now ? wake - now : 1);
+        }
+    }, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "color sort"};
+}
@@ -0,0 +1,70 @@
+#include "pros/rtos.hpp"
+#include "atlas/controller.hpp"
+
+atlas::ControllerInput::ControllerInput(pros::Controller* controller)
+    : controller(controller) {}
+
+const atlas::ControllerState& atlas::ControllerInput::read() {
+    // the first read starts the update period
+    if (time == 0) time = pros::millis();
+    state.leftX = controller->get_analog(pros::E_CONTROLLER_ANALOG_LEFT_X);
+    state.leftY = controller->get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
+    state.rightX = controller->get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_X);
+    state.rightY = controller->get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y);
+    std::uint16_t buttons = 0;
+    for (int button = pros::E_CONTROLLER_DIGITAL_L1; button <= pros::E_CONTROLLER_DIGITAL_A; button++) {
+        const auto digital = static_cast<pros::controller_digital_e_t>(button);
+        if (controller->get_digital(digital) == 1) buttons |= ControllerState::bit(digital);
+    }
+    // edges are found from the previous snapshot, so they line up with the held buttons
+    state.pressed = buttons & ~state.buttons;
+    state.released = state.buttons & ~buttons;
+    state.buttons = buttons;
+    return state;
+}
+
+void atlas::ControllerInput::wait() {
+    pros::Task::delay_until(&time, CONTROLLER_PERIOD);
+}
+
+atlas::ButtonBindings::ButtonBindings(std::vector<Binding> bindings)
+    : bindings(bindings),
+      toggled(bindings.size(), false),
+      outputs(bindings.size()) {}
+
+void atlas::ButtonBindings::update(const ControllerState& state) {
+    for (int i = 0; i < int(bindings.size()); i++) {
+        const Binding& binding = bindings[i];
+        switch (binding.trigger) {
+            case Trigger::PRESS:
+                if (state.newPress(binding.button)) binding.action(binding.value);
+                break;
+            case Trigger::TOGGLE:
+                if (state.newPress(binding.button)) {
+                    toggled[i] = !toggled[i];
+                    binding.action(toggled[i] ? binding.value : 0);
+                }
+                break;
+            case Trigger::HOLD: {
+                // the first HOLD binding of an action decides the value for all of them
+                bool first = true;
+                for (int j = 0; j < i && first; j++)
+                    first = bindings[j].trigger != Trigger::HOLD || bindings[j].action != binding.action;
+                if (!first) break;
+                int value = 0;
+                for (int j = i; j < int(bindings.size()); j++) {
+                    if (bindings[j].trigger == Trigger::HOLD && bindings[j].action == binding.action &&
+                        state.held(bindings[j].button)) {
+                        value = bindings[j].value;
+                        break;
+                    }
+                }
+                if (outputs[i] != value) {
+                    binding.action(value);
+                    outputs[i] = value;
+                }
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#include <cmath>
+#include "atlas/ekf.hpp"
+
+atlas::Ekf::Ekf(float translationNoise, float rotationNoise, float driftNoise)
+    : translationNoise(translationNoise),
+      rotationNoise(rotationNoise),
+      driftNoise(driftNoise) {}
+
+void atlas::Ekf::reset(lemlib::Pose pose, lemlib::Pose variance) {
+    x = {pose.x, pose.y, pose.theta};
+    P = {variance.x, 0, 0,
+         0, variance.y, 0,
+         0, 0, variance.theta};
+}
+
+void atlas::Ekf::predict(float localX, float localY, float deltaTheta, float slipVariance) {
+    // same arc model as the odometry, evaluated at the average heading over the update
+    const float avgHeading = x(2, 0) + deltaTheta / 2;
+    const float s = std::sin(avgHeading);
+    const float c = std::cos(avgHeading);
+    x(0, 0) += localY * s - localX * c;
+    x(1, 0) += localY * c + localX * s;
+    x(2, 0) += deltaTheta;
+
+    // jacobian of the motion with respect to the state. Only the heading changes where the motion goes
+    const Matrix<3, 3> F = {1, 0, localY * c + localX * s,
+                            0, 1, -localY * s + localX * c,
+                            0, 0, 1};
+    // wheels slip more the further the robot travels, and the heading drifts more the further it turns
+    const float translationVar = translationNoise * (std::fabs(localX) + std::fabs(localY)) + slipVariance;
+    const float rotationVar = rotationNoise * std::fabs(deltaTheta) + driftNoise;
+    const Matrix<3, 3> Q = {translationVar, 0, 0,
+                            0, translationVar, 0,
+                            0, 0, rotationVar};
+    P = F * P * F.transpose() + Q;
+}
+
+lemlib::Pose atlas::Ekf::getPose() const { return {x(0, 0), x(1, 0), x(2, 0)}; }
+
+const atlas::Matrix<3, 3>& atlas::Ekf::getCovariance() const { return P; }
@@ -0,0 +1,47 @@
+#include <cmath>
+#include "pros/rtos.hpp"
+#include "lemlib/util.hpp"
+#include "atlas/exitcondition.hpp"
+
+atlas::SettleExitCondition::SettleExitCondition(const SettleSettings& settings)
+    : lemlib::ExitCondition(settings.range, settings.time),
+      maxSpeed(settings.maxSpeed),
+      maxAccel(settings.maxAccel) {}
+
+bool atlas::SettleExitCondition::update(const float error, const float speed) {
+    const int now = pros::millis();
+    // the derivatives need a previous sample
+    if (prevTime == -1) {
+        prevError = error;
+        prevSpeed = speed;
+        prevTime = now;
+        return done;
+    }
+    const float dt = (now - prevTime) / 1000.0;
+    if (dt <= 0) return done;
+
+    // a single 10ms difference is too noisy to use on its own, so smooth the derivatives
+    errorRate = lemlib::ema((error - prevError) / dt, errorRate, 0.5);
+    accel = lemlib::ema((speed - prevSpeed) / dt, accel, 0.5);
+    prevError = error;
+    prevSpeed = speed;
+    prevTime = now;
+
+    // predict where the error will end up if the robot brakes as gently as maxAccel allows
+    const float predictedError = maxAccel > 0 ? error + errorRate * std::fabs(errorRate) / (2 * maxAccel) : error;
+    const bool settled = std::fabs(error) < range && std::fabs(predictedError) < range &&
+                         std::fabs(speed) < maxSpeed && std::fabs(accel) < maxAccel;
+
+    // the robot has to stay settled for the dwell time
+    if (!settled) startTime = -1;
+    else if (startTime == -1) startTime = now;
+    else if (now - startTime >= time) done = true;
+    return done;
+}
+
+void atlas::SettleExitCondition::reset() {
+    lemlib::ExitCondition::reset();
+    errorRate = 0;
+    accel = 0;
+    prevTime = -1;
+}
@@ -0,0 +1,73 @@
+#include <cmath>
+#include <cstdlib>
+#include "pros/error.h"
+#include "lemlib/logger/logger.hpp"
+#include "atlas/intake.hpp"
+
+atlas::Intake::Intake(pros::Motor* motor, IntakeSettings settings, IntakeMode mode)
+    : motor(motor),
+      settings(settings),
+      mode(mode) {}
+
+void atlas::Intake::move(int power) {
+    this->power = power;
+    if (task == nullptr) update();
+}
+
+void atlas::Intake::setMode(IntakeMode mode) { this->mode = mode; }
+
+bool atlas::Intake::isUnjamming() const { return unjamming; }
+
+pros::Motor* atlas::Intake::getMotor() const { return motor.getMotor(); }
+
+void atlas::Intake::update() {
+    const int power = this->power;
+    const std::uint32_t now = pros::millis();
+    pros::Motor* device = motor.getMotor();
+
+    if (unjamming) {
+        if (now - unjamStart < settings.unjamTime) return;
+        unjamming = false;
+        jamStart = 0;
+    }
+
+    // jammed if it is told to move, but barely turns while pushing hard
+    if (power != 0) {
+        const double velocity = device->get_actual_velocity();
+        const std::int32_t current = device->get_current_draw();
+        const bool stalled = velocity != PROS_ERR_F && current != PROS_ERR &&
+                             velocity * (power > 0 ? 1 : -1) < settings.jamVelocity && current > settings.jamCurrent;
+        if (!stalled) jamStart = 0;
+        else if (jamStart == 0) jamStart = now;
+        else if (now - jamStart >= settings.jamTime) {
+            // run backwards at full power to clear it
+            unjamming = true;
+            unjamStart = now;
+            motor.moveVoltage(power > 0 ? -12000 : 12000);
+            lemlib::infoSink()->debug("Intake on port {} jammed, reversing", device->get_port());
+            return;
+        }
+    } else jamStart = 0;
+
+    if (mode == IntakeMode::VOLTAGE) motor.move(power);
+    else {
+        int maxVelocity = 200;
+        switch (device->get_gearing()) {
+            case pros::MotorGears::red: maxVelocity = 100; break;
+            case pros::MotorGears::blue: maxVelocity = 600; break;
+            default: break;
+        }
+        motor.moveVelocity(std::lround(power / 127.0 * maxVelocity));
+    }
+}
+
+void atlas::Intake::start(std::uint32_t period) {
+    if (task != nullptr) return;
+    task = new pros::Task {[this, period] {
+        std::uint32_t now = pros::millis();
+        while (true) {
+            update();
+            pros::Task::delay_until(&now, period);
+        }
+    }, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "intake"};
+}
@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <cmath>
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/util.hpp"
+#include "atlas/chassis/odom.hpp"
+#include "atlas/particlefilter.hpp"
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+// variance added per inch traveled. Larger than the odometry filter, so the particles cover the drift
+constexpr float TRANSLATION_NOISE = 0.02;
+// variance added per radian turned
+constexpr float ROTATION_NOISE = 0.002;
+// position and heading variance added every update. Without it, the particles collapse onto a few poses while the
+// robot is still
+constexpr float POSITION_JITTER = 0.01;
+constexpr float DRIFT_NOISE = 1e-5;
+// the distance sensor is accurate to 15mm up close and 5% further away
+constexpr float MIN_STDEV = 0.6;
+constexpr float RELATIVE_STDEV = 0.05;
+// a reading more than 3 standard deviations off is probably a game element or robot, so it can't lower the weight of
+// a particle any further than this
+constexpr float MIN_LOG_LIKELIHOOD = -4.5;
+// fraction of particles replaced with random ones every resample, so the filter can find the robot if every
+// particle is wrong
+constexpr float RANDOM_FRACTION = 0.02;
+// the distance sensors can't be parallel to a wall, but this stops the division by zero
+constexpr float MIN_DIRECTION = 1e-6;
+// how the particles start out around the odometry pose
+constexpr float START_POSITION_SPREAD = 12;
+constexpr float START_HEADING_SPREAD = lemlib::degToRad(15);
+// the particles agree when they are spread less than this, in inches
+constexpr float CONVERGED_SPREAD = 2;
+// odometry is only corrected when it is this far from the particles
+constexpr float MAX_POSITION_DISAGREEMENT = 4;
+constexpr float MAX_HEADING_DISAGREEMENT = lemlib::degToRad(10);
+// variance of the heading published to odometry, in rad^2
+constexpr float HEADING_VARIANCE = lemlib::degToRad(2) * lemlib::degToRad(2);
+// how often the filter updates, in ms
+constexpr int UPDATE_PERIOD = 50;
+
+atlas::ParticleFilter::ParticleFilter(std::vector<DistanceSensor> sensors)
+    : sensors(sensors),
+      prevReadings(sensors.size(), -1) {
+    reset(lemlib::Pose(0, 0, 0), START_POSITION_SPREAD, START_HEADING_SPREAD);
+}
+
+float atlas::ParticleFilter::uniform() {
+    // xorshift, which is plenty random for noise and much faster than the standard library
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return (seed >> 8) * (1.0f / (1 << 24));
+}
+
+float atlas::ParticleFilter::gaussian() {
+    // the sum of 4 uniform numbers is close enough to normal, without the log and sqrt of Box-Muller
+    return (uniform() + uniform() + uniform() + uniform() - 2) * std::sqrt(3.0f);
+}
+
+void atlas::ParticleFilter::updateTrig() {
+    for (int i = 0; i < NUM_PARTICLES; i++) {
+        sinTheta[i] = std::sin(theta[i]);
+        cosTheta[i] = std::cos(theta[i]);
+    }
+}
+
+void atlas::ParticleFilter::reset(lemlib::Pose pose, float positionSpread, float headingSpread) {
+    for (int i = 0; i < NUM_PARTICLES; i++) {
+        x[i] = pose.x + positionSpread * gaussian();
+        y[i] = pose.y + positionSpread * gaussian();
+        theta[i] = pose.theta + headingSpread * gaussian();
+    }
+    logWeight.fill(0);
+    updateTrig();
+}
+
+void atlas::ParticleFilter::predict(float localX, float localY, float deltaTheta) {
+    // give every particle its own noisy copy of the motion
+    const float translationStdev =
+        std::sqrt(TRANSLATION_NOISE * (std::fabs(localX) + std::fabs(localY)) + POSITION_JITTER);
+    const float rotationStdev = std::sqrt(ROTATION_NOISE * std::fabs(deltaTheta) + DRIFT_NOISE);
+    for (int i = 0; i < NUM_PARTICLES; i++) {
+        scratchX[i] = localX + translationStdev * gaussian();
+        scratchY[i] = localY + translationStdev * gaussian();
+        scratchTheta[i] = deltaTheta + rotationStdev * gaussian();
+    }
+    // the motion happens along the average heading. NEON has no trig, so this part stays scalar
+    for (int i = 0; i < NUM_PARTICLES; i++) {
+        const float avgHeading = theta[i] + scratchTheta[i] / 2;
+        sinTheta[i] = std::sin(avgHeading);
+        cosTheta[i] = std::cos(avgHeading);
+    }
+
+#ifdef __ARM_NEON
+    for (int i = 0; i < NUM_PARTICLES; i += 4) {
+        const float32x4_t s = vld1q_f32(&sinTheta[i]);
+        const float32x4_t c = vld1q_f32(&cosTheta[i]);
+        const float32x4_t dx = vld1q_f32(&scratchX[i]);
+        const float32x4_t dy = vld1q_f32(&scratchY[i]);
+        // x += dx * cos + dy * sin, y += dy * cos - dx * sin
+        vst1q_f32(&x[i], vmlaq_f32(vmlaq_f32(vld1q_f32(&x[i]), dx, c), dy, s));
+        vst1q_f32(&y[i], vmlsq_f32(vmlaq_f32(vld1q_f32(&y[i]), dy, c), dx, s));
+        vst1q_f32(&theta[i], vaddq_f32(vld1q_f32(&theta[i]), vld1q_f32(&scratchTheta[i])));
+    }
+#else
+    for (int i = 0; i < NUM_PARTICLES; i++) {
+        x[i] += scratchX[i] * cosTheta[i] + scratchY[i] * sinTheta[i];
+        y[i] += scratchY[i] * cosTheta[i] - scratchX[i] * sinTheta[i];
+        theta[i] += scratchTheta[i];
+    }
+#endif
+    updateTrig();
+}
+
+#ifdef __ARM_NEON
+/**
+ * @brief Distance along a ray to the wall it is heading towards, for 4 rays at once
+ *
+ * @param position position of the start of the rays along the axis of the walls
+ * @param direction component of the ray directions along the axis of the walls
+ */
+static float32x4_t distanceToWall(float32x4_t position, float32x4_t direction) {
+    const uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(direction), vdupq_n_u32(0x80000000));
+    const float32x4_t wall =
+        vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(vdupq_n_f32(atlas::FIELD_HALF_WIDTH)), sign));
+    const float32x4_t magnitude = vmaxq_f32(vabsq_f32(direction), vdupq_n_f32(MIN_DIRECTION));
+    const float32x4_t safeDirection = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(magnitude), sign));
+    // the Cortex-A9 has no vector divide, so refine the reciprocal estimate with 2 Newton-Raphson steps
+    float32x4_t reciprocal = vrecpeq_f32(safeDirection);
+    reciprocal = vmulq_f32(vrecpsq_f32(safeDirection, reciprocal), reciprocal);
+    reciprocal = vmulq_f32(vrecpsq_f32(safeDirection, reciprocal), reciprocal);
+    return vmulq_f32(vsubq_f32(wall, position), reciprocal);
+}
+#else
+/**
+ * @brief Distance along a ray to the wall it is heading towards
+ *
+ * @param position position of the start of the ray along the axis of the walls
+ * @param direction component of the ray direction along the axis of the walls
+ */
+static float distanceToWall(float position, float direction) {
+    const float safeDirection = std::copysign(std::fmax(std::fabs(direction), MIN_DIRECTION), direction);
+    return (std::copysign(atlas::FIELD_HALF_WIDTH, direction) - position) / safeDirection;
+}
+#endif
+
+void atlas::ParticleFilter::weigh(int sensor, float reading) {
+    const float xOffset = sensors[sensor].getXOffset();
+    const float yOffset = sensors[sensor].getYOffset();
+    const float sinAngle = std::sin(sensors[sensor].getAngle());
+    const float cosAngle = std::cos(sensors[sensor].getAngle());
+    const float stdev = std::fmax(MIN_STDEV, RELATIVE_STDEV * reading);
+    const float gain = -0.5f / (stdev * stdev);
+
+#ifdef __ARM_NEON
+    for (int i = 0; i < NUM_PARTICLES; i += 4) {
+        const float32x4_t s = vld1q_f32(&sinTheta[i]);
+        const float32x4_t c = vld1q_f32(&cosTheta[i]);
+        // position of the sensor on the field
+        const float32x4_t sensorX = vmlaq_n_f32(vmlaq_n_f32(vld1q_f32(&x[i]), c, xOffset), s, yOffset);
+        const float32x4_t sensorY = vmlaq_n_f32(vmlsq_n_f32(vld1q_f32(&y[i]), s, xOffset), c, yOffset);
+        // direction of the beam, the particle heading rotated by the sensor angle
+        const float32x4_t dx = vmlaq_n_f32(vmulq_n_f32(s, cosAngle), c, sinAngle);
+        const float32x4_t dy = vmlsq_n_f32(vmulq_n_f32(c, cosAngle), s, sinAngle);
+        // the beam hits whichever wall is closer
+        const float32x4_t expected = vminq_f32(distanceToWall(sensorX, dx), distanceToWall(sensorY, dy));
+        const float32x4_t error = vsubq_f32(vdupq_n_f32(reading), expected);
+        const float32x4_t logLikelihood =
+            vmaxq_f32(vmulq_n_f32(vmulq_f32(error, error), gain), vdupq_n_f32(MIN_LOG_LIKELIHOOD));
+        vst1q_f32(&logWeight[i], vaddq_f32(vld1q_f32(&logWeight[i]), logLikelihood));
+    }
+#else
+    for (int i = 0; i < NUM_PARTICLES; i++) {
+        const float s = sinTheta[i];
+        const float c = cosTheta[i];
+        // position of the sensor on the field
+        const float sensorX = x[i] + xOffset * c + yOffset * s;
+        const float sensorY = y[i] - xOffset * s + yOffset * c;
+        // direction of the beam, the particle heading rotated by the sensor angle
+        const float dx = s * cosAngle + c * sinAngle;
+        const float dy = c * cosAngle - s * sinAngle;
+        // the beam hits whichever wall is closer
+        const float expected = std::fmin(distanceToWall(sensorX, dx), distanceToWall(sensorY, dy));
+        const float error = reading - expected;
+        logWeight[i] += std::fmax(error * error * gain, MIN_LOG_LIKELIHOOD);
+    }
+#endif
+}
+
+void atlas::ParticleFilter::normalizedWeights(std::array<float, NUM_PARTICLES>& weights) const {
+    // subtract the largest log weight first, so exp can't underflow to 0 for every particle
+    const float maxLogWeight = *std::max_element(logWeight.begin(), logWeight.end());
+    float sum = 0;
+    for (int i = 0; i < NUM_PARTICLES; i++) {
+        weights[i] = std::exp(logWeight[i] - maxLogWeight);
+        sum += weights[i];
+    }
+    for (float& weight : weights) weight /= sum;
+}
+
+void atlas::ParticleFilter::resample() {
+    std::array<float, NUM_PARTICLES> weights;
+    normalizedWeights(weights);
+    // only resample once the weights are uneven, otherwise resampling just throws away diversity
+    float sumSquares = 0;
+    for (float weight : weights) sumSquares += weight * weight;
+    if (1 / sumSquares > NUM_PARTICLES / 2) return;
+
+    // low variance resampling, which keeps a particle with weight w about w * NUM_PARTICLES times
+    const float step = 1.0f / NUM_PARTICLES;
+    float target = uniform() * step;
+    float cumulative = weights[0];
+    int source = 0;
+    for (int i = 0; i < NUM_PARTICLES; i++) {
+        while (target > cumulative && source < NUM_PARTICLES - 1) cumulative += weights[++source];
+        scratchX[i] = x[source];
+        scratchY[i] = y[source];
+        scratchTheta[i] = theta[source];
+        target += step;
+    }
+    x = scratchX;
+    y = scratchY;
+    theta = scratchTheta;
+
+    // scatter a few particles anywhere on the field
+    for (int i = 0; i < int(NUM_PARTICLES * RANDOM_FRACTION); i++) {
+        const int index = int(uniform() * NUM_PARTICLES) % NUM_PARTICLES;
+        x[index] = (uniform() * 2 - 1) * FIELD_HALF_WIDTH;
+        y[index] = (uniform() * 2 - 1) * FIELD_HALF_WIDTH;
+        theta[index] = uniform() * 2 * M_PI;
+    }
+    logWeight.fill(0);
+    updateTrig();
+}
+
+lemlib::Pose atlas::ParticleFilter::getEstimate() const {
+    std::array<float, NUM_PARTICLES> weights;
+    normalizedWeights(weights);
+    // average the heading relative to one particle, so headings either side of 0 don't cancel out
+    lemlib::Pose estimate(0, 0, theta[0]);
+    for (int i = 0; i < NUM_PARTICLES; i++) {
+        estimate.x += weights[i] * x[i];
+        estimate.y += weights[i] * y[i];
+        estimate.theta += weights[i] * std::remainder(theta[i] - theta[0], 2 * M_PI);
+    }
+    return estimate;
+}
+
+float atlas::ParticleFilter::getSpread() const {
+    std::array<float, NUM_PARTICLES> weights;
+    normalizedWeights(weights);
+    const lemlib::Pose estimate = getEstimate();
+    float variance = 0;
+    for (int i = 0; i < NUM_PARTICLES; i++) {
+        variance += weights[i] * (std::pow(x[i] - estimate.x, 2) + std::pow(y[i] - estimate.y, 2));
+    }
+    return std::sqrt(variance);
+}
+
+void atlas::ParticleFilter::start() {
+    if (task != nullptr) return;
+    reset(atlas::getPose(true), START_POSITION_SPREAD, START_HEADING_SPREAD);
+    // below the odometry task, so localizing never delays odometry or the motions
+    task = new pros::Task {[this] {
+        lemlib::Pose prevPose = atlas::getOdomPose(true);
+        std::uint32_t now = pros::millis();
+        while (true) {
+            // how far the robot moved since the last update, in the frame of the robot
+            const lemlib::Pose pose = atlas::getOdomPose(true);
+            const float deltaTheta = pose.theta - prevPose.theta;
+            const float avgHeading = prevPose.theta + deltaTheta / 2;
+            const float dx = pose.x - prevPose.x;
+            const float dy = pose.y - prevPose.y;
+            predict(dx * std::cos(avgHeading) - dy * std::sin(avgHeading),
+                    dx * std::sin(avgHeading) + dy * std::cos(avgHeading), deltaTheta);
+            prevPose = pose;
+
+            for (int i = 0; i < int(sensors.size()); i++) {
+                const std::optional<float> reading = sensors[i].read();
+                // the sensor updates slower than the filter, so don't weigh the same reading twice
+                if (!reading || *reading == prevReadings[i]) continue;
+                prevReadings[i] = *reading;
+                weigh(i, *reading);
+            }
+            resample();
+
+            // publish the estimate once the particles agree on one, if odometry has lost track
+            const float spread = getSpread();
+            if (spread < CONVERGED_SPREAD) {
+                const lemlib::Pose estimate = getEstimate();
+                const lemlib::Pose odom = atlas::getPose(true);
+                if (estimate.distance(odom) > MAX_POSITION_DISAGREEMENT ||
+                    std::fabs(lemlib::angleError(estimate.theta, odom.theta)) > MAX_HEADING_DISAGREEMENT) {
+                    atlas::correctPose(estimate, {spread * spread, spread * spread, HEADING_VARIANCE});
+                    lemlib::infoSink()->warn("Particle filter relocalized odometry to x: {} y: {} theta: {}",
+                                             estimate.x, estimate.y, lemlib::radToDeg(estimate.theta));
+                }
+            }
+            pros::Task::delay_until(&now, UPDATE_PERIOD);
+        }
+    }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "particle filter"};
+}
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include "pros/rtos.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "atlas/path.hpp"
+
+/**
+ * @brief Parse a number followed by an optional comma
+ *
+ * @param str string to parse. Advanced past the number and comma
+ * @param out the parsed number
+ * @return true a number was parsed
+ * @return false there was no number to parse
+ */
+static bool parseNumber(const char*& str, float& out) {
+    char* end;
+    out = std::strtof(str, &end);
+    if (end == str) return false;
+    str = end;
+    if (*str == ',') str++;
+    return true;
+}
+
+std::vector<lemlib::Pose> atlas::getPathPoints(const asset& path) {
+    std::vector<lemlib::Pose> points;
+    // copy the asset so the parser can rely on a null terminator
+    const std::string data(reinterpret_cast<char*>(path.buf), path.size);
+    const char* line = data.c_str();
+    // each line is "x, y, speed" until the endData marker
+    while (*line != '\0' && std::strncmp(line, "endData", 7) != 0) {
+        float x, y, speed;
+        if (!parseNumber(line, x) || !parseNumber(line, y) || !parseNumber(line, speed)) break;
+        points.emplace_back(x, y, speed);
+        // move on to the next line
+        line = std::strchr(line, '\n');
+        if (line == nullptr) break;
+        line++;
+    }
+    return points;
+}
+
+/**
+ * @brief Find a JSON number field
+ *
+ * @param json the JSON string
+ * @param key the quoted key of the field, followed by a colon
+ * @param pos where to start searching. Advanced past the number if it was found
+ * @param end where to stop searching
+ * @param out the parsed number
+ * @return true the field was found
+ * @return false the field was not found
+ */
+static bool findNumber(const std::string& json, const char* key, size_t& pos, size_t end, float& out) {
+    const size_t found = json.find(key, pos);
+    if (found == std::string::npos || found >= end) return false;
+    const char* str = json.c_str() + found + std::strlen(key);
+    if (!parseNumber(str, out)) return false;
+    pos = str - json.c_str();
+    return true;
+}
+
+/**
+ * @brief Find the index of the path point closest to a position
+ *
+ * @param points the path points
+ * @param x x position
+ * @param y y position
+ * @param start index to start searching from
+ * @return int index of the closest point
+ */
+static int closestIndex(const std::vector<lemlib::Pose>& points, float x, float y, int start) {
+    int closest = start;
+    for (int i = start; i < int(points.size()); i++) {
+        if (points.at(i).distance(lemlib::Pose(x, y)) < points.at(closest).distance(lemlib::Pose(x, y))) closest = i;
+    }
+    return closest;
+}
+
+std::vector<float> atlas::getLookaheadRatios(const asset& path, const std::vector<lemlib::Pose>& points) {
+    std::vector<float> ratios(points.size(), -1);
+    const std::string data(reinterpret_cast<char*>(path.buf), path.size);
+    size_t pos = data.find("#PATH.JERRYIO-DATA");
+    if (pos == std::string::npos || points.empty()) return ratios;
+
+    // keyframe positions, as point indices, and their values
+    std::vector<std::pair<int, float>> keyframes;
+    int segmentStart = 0;
+    // every bezier segment has its controls, followed by its keyframes
+    while ((pos = data.find("\"controls\":[", pos)) != std::string::npos) {
+        const size_t controlsEnd = data.find(']', pos);
+        if (controlsEnd == std::string::npos) break;
+        // the first and last controls are the end points of the segment
+        float startX, startY, endX = 0, endY = 0;
+        if (!findNumber(data, "\"x\":", pos, controlsEnd, startX) ||
+            !findNumber(data, "\"y\":", pos, controlsEnd, startY))
+            break;
+        float x, y;
+        while (findNumber(data, "\"x\":", pos, controlsEnd, x) && findNumber(data, "\"y\":", pos, controlsEnd, y)) {
+            endX = x;
+            endY = y;
+        }
+        segmentStart = closestIndex(points, startX, startY, segmentStart);
+        const int segmentEnd = closestIndex(points, endX, endY, segmentStart);
+
+        pos = data.find("\"lookaheadKeyframes\":[", controlsEnd);
+        if (pos == std::string::npos) break;
+        const size_t keyframesEnd = data.find(']', pos);
+        float xPos, yPos;
+        while (findNumber(data, "\"xPos\":", pos, keyframesEnd, xPos) &&
+               findNumber(data, "\"yPos\":", pos, keyframesEnd, yPos)) {
+            const int index = segmentStart + std::lround(std::clamp(xPos, 0.0f, 1.0f) * (segmentEnd - segmentStart));
+            keyframes.emplace_back(index, std::clamp(yPos, 0.0f, 1.0f));
+        }
+        pos = keyframesEnd;
+        segmentStart = segmentEnd;
+    }
+
+    // each keyframe holds until the next one
+    std::sort(keyframes.begin(), keyframes.end());
+    for (size_t i = 0; i < keyframes.size(); i++) {
+        const int end = i + 1 < keyframes.size() ? keyframes.at(i + 1).first : ratios.size();
+        std::fill(ratios.begin() + keyframes.at(i).first, ratios.begin() + end, keyframes.at(i).second);
+    }
+    return ratios;
+}
+
+/**
+ * @brief A parsed path asset
+ */
+struct ParsedPath {
+        std::vector<lemlib::Pose> points;
+        std::vector<float> lookaheadRatios;
+};
+
+// preloaded paths, by the address of their data
+static std::map<const uint8_t*, ParsedPath> preloaded;
+static pros::Mutex preloadedMutex;
+
+/**
+ * @brief Parse a path asset, or get it from the preloaded paths
+ *
+ * @param path the path asset
+ * @return ParsedPath the points and lookahead keyframes of the path
+ */
+static ParsedPath parsePath(const asset& path) {
+    {
+        std::lock_guard<pros::Mutex> lock(preloadedMutex);
+        const auto found = preloaded.find(path.buf);
+        if (found != preloaded.end()) return found->second;
+    }
+    ParsedPath parsed;
+    parsed.points = atlas::getPathPoints(path);
+    parsed.lookaheadRatios = atlas::getLookaheadRatios(path, parsed.points);
+    return parsed;
+}
+
+void atlas::preloadPath(const asset& path) {
+    ParsedPath parsed = parsePath(path);
+    std::lock_guard<pros::Mutex> lock(preloadedMutex);
+    preloaded.emplace(path.buf, std::move(parsed));
+}
+
+std::vector<atlas::PathRun> atlas::joinSegments(const std::vector<PathSegment>& segments) {
+    std::vector<PathRun> runs;
+    size_t segmentStart = 0; // index of the first point of the last segment in the last run
+    for (size_t i = 0; i < segments.size(); i++) {
+        const PathSegment& segment = segments.at(i);
+        ParsedPath parsed = parsePath(segment.path);
+        std::vector<lemlib::Pose>& points = parsed.points;
+        if (points.empty()) {
+            lemlib::infoSink()->warn("Path segment {} has no points, skipping it", i);
+            continue;
+        }
+        const std::vector<float>& ratios = parsed.lookaheadRatios;
+        // apply the speed cap of the segment
+        for (lemlib::Pose& point : points) point.theta = std::min(point.theta, segment.maxSpeed);
+
+        // start a new run if the direction changes
+        if (runs.empty() || runs.back().forwards != segment.forwards) {
+            runs.push_back({points, segment.forwards, ratios});
+            segmentStart = 0;
+            continue;
+        }
+
+        // drop the stopping points at the end of the previous segment so the robot carries its speed through the
+        // joint. This includes the extra point path.jerryio adds past the end of the path
+        PathRun& run = runs.back();
+        while (!run.points.empty() && run.points.back().theta == 0) {
+            run.points.pop_back();
+            run.lookaheadRatios.pop_back();
+        }
+        // path.jerryio ramps the speed down to the end of the previous segment and up from the start of this one.
+        // Raise both ramps to the slower of the two top speeds, so the robot carries that speed through the joint
+        if (run.points.size() > segmentStart) {
+            // walk back from the end of the previous segment to the top of its ramp down
+            size_t rampStart = run.points.size() - 1;
+            while (rampStart > segmentStart && run.points.at(rampStart - 1).theta >= run.points.at(rampStart).theta)
+                rampStart--;
+            // walk forwards from the start of this segment to the top of its ramp up
+            size_t rampEnd = 0;
+            while (rampEnd + 1 < points.size() && points.at(rampEnd + 1).theta >= points.at(rampEnd).theta) rampEnd++;
+            const float jointSpeed = std::min(run.points.at(rampStart).theta, points.at(rampEnd).theta);
+            for (size_t j = rampStart; j < run.points.size(); j++)
+                run.points.at(j).theta = std::max(run.points.at(j).theta, jointSpeed);
+            for (size_t j = 0; j <= rampEnd; j++) points.at(j).theta = std::max(points.at(j).theta, jointSpeed);
+        }
+        // skip the first point of this segment if it duplicates the joint
+        size_t start = 0;
+        if (!run.points.empty() && run.points.back().distance(points.front()) < 0.01) start = 1;
+        segmentStart = run.points.size();
+        run.points.insert(run.points.end(), points.begin() + start, points.end());
+        run.lookaheadRatios.insert(run.lookaheadRatios.end(), ratios.begin() + start, ratios.end());
+    }
+    return runs;
+}
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "pros/error.h"
+#include "pros/misc.h"
+#include "pros/motors.h"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/util.hpp"
+#include "atlas/power.hpp"
+
+// how often the motors are checked, in ms. Temperature changes slowly
+constexpr std::uint32_t UPDATE_PERIOD = 100;
+// current limit of a cool motor, and the lowest limit a hot one is turned down to, in mA
+constexpr float MAX_CURRENT = 2500;
+constexpr float MIN_CURRENT = 1200;
+// the limit is lowered as the hottest motor heats up from here, in degrees Celsius
+constexpr float THROTTLE_START_TEMPERATURE = 45;
+// the limit reaches MIN_CURRENT here, just before the motors halve their own power
+constexpr float THROTTLE_END_TEMPERATURE = 54;
+// the limit is lowered as the battery sags from here, in mV
+constexpr float SAG_START_VOLTAGE = 11500;
+// the brain browns out around here, so the drive gets MIN_CURRENT, in mV
+constexpr float SAG_END_VOLTAGE = 10000;
+// the limit is only sent when it changes by more than this, in mA
+constexpr int LIMIT_STEP = 50;
+
+atlas::PowerManager::PowerManager(pros::MotorGroup* leftMotors, pros::MotorGroup* rightMotors) {
+    for (pros::MotorGroup* group : {leftMotors, rightMotors}) {
+        for (std::int8_t port : group->get_port_all()) {
+            if (motorCount == MAX_DRIVE_MOTORS) break;
+            ports[motorCount++] = std::abs(port);
+        }
+    }
+}
+
+void atlas::PowerManager::update() {
+    // read every motor in one pass
+    float hottest = 0;
+    float current = 0;
+    float power = 0;
+    bool overTemp = false;
+    for (int i = 0; i < motorCount; i++) {
+        const double temperature = pros::c::motor_get_temperature(ports[i]);
+        const std::int32_t draw = pros::c::motor_get_current_draw(ports[i]);
+        const double watts = pros::c::motor_get_power(ports[i]);
+        if (temperature != PROS_ERR_F) hottest = std::max(hottest, float(temperature));
+        if (draw != PROS_ERR) current += draw;
+        if (watts != PROS_ERR_F) power += watts;
+        overTemp = overTemp || pros::c::motor_is_over_temp(ports[i]) == 1;
+    }
+    maxTemperature = hottest;
+    totalCurrent = current;
+    totalPower = power;
+
+    // scale from the full limit down to the minimum as the motors heat up or the battery sags
+    const float heat = std::clamp((hottest - THROTTLE_START_TEMPERATURE) /
+                                      (THROTTLE_END_TEMPERATURE - THROTTLE_START_TEMPERATURE),
+                                  0.0f, 1.0f);
+    const std::int32_t voltage = pros::c::battery_get_voltage();
+    // compensated output needs the current the sagging battery can still give, so only the heat lowers the limit
+    const float sag =
+        voltage == PROS_ERR || voltageCompensated
+            ? 0
+            : std::clamp((SAG_START_VOLTAGE - voltage) / (SAG_START_VOLTAGE - SAG_END_VOLTAGE), 0.0f, 1.0f);
+    const int limit = std::lround(MAX_CURRENT - (MAX_CURRENT - MIN_CURRENT) * std::max(heat, sag));
+
+    // only send small changes once they add up, but always reach the ends of the range
+    const bool atEnd = limit == MAX_CURRENT || limit == MIN_CURRENT;
+    if (limit != currentLimit && (currentLimit == 0 || atEnd || std::abs(limit - currentLimit) >= LIMIT_STEP)) {
+        for (int i = 0; i < motorCount; i++) pros::c::motor_set_current_limit(ports[i], limit);
+        currentLimit = limit;
+    }
+
+    const bool nowThrottling = limit < MAX_CURRENT;
+    if (nowThrottling && !throttling)
+        lemlib::infoSink()->warn("Drivetrain throttled to {} mA, hottest motor {} C, battery {} mV", limit, hottest,
+                                 voltage);
+    else if (!nowThrottling && throttling) lemlib::infoSink()->info("Drivetrain back to full current");
+    if (overTemp && !wasOverTemp) lemlib::infoSink()->warn("Drive motor over temperature, hottest {} C", hottest);
+    throttling = nowThrottling;
+    wasOverTemp = overTemp;
+}
+
+void atlas::PowerManager::start() {
+    if (task != nullptr) return;
+    task = new pros::Task {[this] {
+        std::uint32_t now = pros::millis();
+        while (true) {
+            update();
+            pros::Task::delay_until(&now, UPDATE_PERIOD);
+        }
+    }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "power manager"};
+}
+
+void atlas::PowerManager::setVoltageCompensated(bool compensated) { voltageCompensated = compensated; }
+
+float atlas::PowerManager::getMaxTemperature() const { return maxTemperature; }
+
+float atlas::PowerManager::getTotalCurrent() const { return totalCurrent; }
+
+float atlas::PowerManager::getTotalPower() const { return totalPower; }
+
+int atlas::PowerManager::getCurrentLimit() const { return currentLimit; }
@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <cmath>
+#include "atlas/profile.hpp"
+
+atlas::TrapezoidalProfile::TrapezoidalProfile(float distance, float maxVelocity, float maxAccel, float startVelocity,
+                                              float endVelocity)
+    : distance(std::fabs(distance)),
+      accel(std::fmax(std::fabs(maxAccel), 1e-3)) {
+    maxVelocity = std::fabs(maxVelocity);
+    startVelocity = std::min(std::fabs(startVelocity), maxVelocity);
+    endVelocity = std::min(std::fabs(endVelocity), maxVelocity);
+    // relax the boundary velocities if they can't be reached over the distance
+    endVelocity = std::min(endVelocity, std::sqrt(startVelocity * startVelocity + 2 * accel * this->distance));
+    startVelocity = std::min(startVelocity, std::sqrt(endVelocity * endVelocity + 2 * accel * this->distance));
+    this->startVelocity = startVelocity;
+    this->endVelocity = endVelocity;
+
+    // peak velocity if the profile never cruises
+    const float peakVelocity = std::sqrt(
+        (2 * accel * this->distance + startVelocity * startVelocity + endVelocity * endVelocity) / 2);
+    cruiseVelocity = std::min(maxVelocity, peakVelocity);
+
+    accelTime = (cruiseVelocity - startVelocity) / accel;
+    decelTime = (cruiseVelocity - endVelocity) / accel;
+    const float accelDist = (cruiseVelocity * cruiseVelocity - startVelocity * startVelocity) / (2 * accel);
+    const float decelDist = (cruiseVelocity * cruiseVelocity - endVelocity * endVelocity) / (2 * accel);
+    cruiseTime = cruiseVelocity > 0 ? std::fmax(this->distance - accelDist - decelDist, 0) / cruiseVelocity : 0;
+}
+
+atlas::ProfileState atlas::TrapezoidalProfile::sample(float time) const {
+    if (time <= 0) return {0, startVelocity, accel};
+    // accelerating
+    if (time < accelTime) return {startVelocity * time + accel * time * time / 2, startVelocity + accel * time, accel};
+    const float accelDist = startVelocity * accelTime + accel * accelTime * accelTime / 2;
+    // cruising
+    time -= accelTime;
+    if (time < cruiseTime) return {accelDist + cruiseVelocity * time, cruiseVelocity, 0};
+    const float cruiseDist = cruiseVelocity * cruiseTime;
+    // decelerating
+    time -= cruiseTime;
+    if (time < decelTime)
+        return {accelDist + cruiseDist + cruiseVelocity * time - accel * time * time / 2,
+                cruiseVelocity - accel * time, -accel};
+    // done
+    return {distance, endVelocity, 0};
+}
+
+float atlas::TrapezoidalProfile::getDuration() const { return accelTime + cruiseTime + decelTime; }
@@ -0,0 +1,95 @@
+#include <cmath>
+#include "pros/error.h"
+#include "lemlib/util.hpp"
+#include "atlas/relocalize.hpp"
+
+// readings further than this are too noisy to correct with, in mm
+constexpr std::int32_t MAX_RANGE = 1200;
+// the sensor only reports a confidence above this distance, in mm
+constexpr std::int32_t CONFIDENCE_RANGE = 200;
+// readings with less confidence than this are skipped, out of 63
+constexpr std::int32_t MIN_CONFIDENCE = 32;
+// the beam has to hit the wall within about 35 degrees of square, as the cosine of that angle
+constexpr float MIN_INCIDENCE = 0.8;
+// the beam is a cone, so readings that hit the wall this close to a corner may be off the other wall, in inches
+constexpr float CORNER_MARGIN = 6;
+// the sensor is accurate to 15mm up close and 5% further away
+constexpr float MIN_STDEV = 0.6;
+constexpr float RELATIVE_STDEV = 0.05;
+// 99% chi-square for 1 degree of freedom
+constexpr float GATE = 6.63;
+// step used to differentiate the measurement, in inches and radians
+constexpr float EPSILON = 0.01;
+
+atlas::DistanceSensor::DistanceSensor(pros::Distance* sensor, float xOffset, float yOffset, float angle)
+    : sensor(sensor),
+      xOffset(xOffset),
+      yOffset(yOffset),
+      angle(lemlib::degToRad(angle)) {}
+
+std::optional<float> atlas::DistanceSensor::predict(lemlib::Pose pose) const {
+    // position of the sensor on the field
+    const float s = std::sin(pose.theta);
+    const float c = std::cos(pose.theta);
+    const float x = pose.x + xOffset * c + yOffset * s;
+    const float y = pose.y - xOffset * s + yOffset * c;
+    if (std::fabs(x) >= FIELD_HALF_WIDTH || std::fabs(y) >= FIELD_HALF_WIDTH) return std::nullopt;
+
+    // distance along the beam to the left or right wall, and to the top or bottom wall
+    const float dx = std::sin(pose.theta + angle);
+    const float dy = std::cos(pose.theta + angle);
+    const float tx = dx != 0 ? (std::copysign(FIELD_HALF_WIDTH, dx) - x) / dx : INFINITY;
+    const float ty = dy != 0 ? (std::copysign(FIELD_HALF_WIDTH, dy) - y) / dy : INFINITY;
+
+    // the beam hits whichever wall is closer
+    const bool sideWall = tx < ty;
+    const float distance = sideWall ? tx : ty;
+    const float along = sideWall ? y + distance * dy : x + distance * dx;
+    const float incidence = std::fabs(sideWall ? dx : dy);
+    if (std::fabs(along) > FIELD_HALF_WIDTH - CORNER_MARGIN || incidence < MIN_INCIDENCE) return std::nullopt;
+    return distance;
+}
+
+std::optional<float> atlas::DistanceSensor::read() const {
+    const std::int32_t reading = sensor->get();
+    if (reading == PROS_ERR || reading > MAX_RANGE) return std::nullopt;
+    if (reading > CONFIDENCE_RANGE && sensor->get_confidence() < MIN_CONFIDENCE) return std::nullopt;
+    return reading / 25.4;
+}
+
+bool atlas::DistanceSensor::correct(Ekf& ekf) {
+    const std::optional<float> measured = read();
+    if (!measured) return false;
+    // the sensor updates slower than odometry, so don't fuse the same reading twice
+    if (*measured == prevReading) return false;
+    prevReading = *measured;
+
+    const lemlib::Pose pose = ekf.getPose();
+    const std::optional<float> expected = predict(pose);
+    if (!expected) return false;
+
+    // differentiate the predicted reading with respect to each state
+    Matrix<1, 3> H;
+    for (int i = 0; i < 3; i++) {
+        lemlib::Pose ahead = pose;
+        lemlib::Pose behind = pose;
+        float& aheadValue = i == 0 ? ahead.x : i == 1 ? ahead.y : ahead.theta;
+        float& behindValue = i == 0 ? behind.x : i == 1 ? behind.y : behind.theta;
+        aheadValue += EPSILON;
+        behindValue -= EPSILON;
+        const std::optional<float> aheadDistance = predict(ahead);
+        const std::optional<float> behindDistance = predict(behind);
+        // too close to an edge case to linearize
+        if (!aheadDistance || !behindDistance) return false;
+        H(0, i) = (*aheadDistance - *behindDistance) / (2 * EPSILON);
+    }
+
+    const float stdev = std::fmax(MIN_STDEV, RELATIVE_STDEV * *measured);
+    return ekf.correct<1>({*measured - *expected}, H, {stdev * stdev}, GATE);
+}
+
+float atlas::DistanceSensor::getXOffset() const { return xOffset; }
+
+float atlas::DistanceSensor::getYOffset() const { return yOffset; }
+
+float atlas::DistanceSensor::getAngle() const { return angle; }
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cmath>
+#include "atlas/trajectory.hpp"
+
+atlas::Trajectory::Trajectory(const std::vector<lemlib::Pose>& path, bool forwards, float maxVelocity,
+                              float maxAccel, float trackWidth, float startVelocity)
+    : forwards(forwards) {
+    // copy the path up to the first stopping point. Duplicate points are skipped since they have no heading
+    for (const lemlib::Pose& pathPoint : path) {
+        const bool stop = pathPoint.theta == 0;
+        if (!points.empty() && std::hypot(pathPoint.x - points.back().x, pathPoint.y - points.back().y) < 0.01) {
+            if (stop) break;
+            continue;
+        }
+        points.push_back({pathPoint.x, pathPoint.y, 0, 0, pathPoint.theta / 127 * maxVelocity, 0, 0});
+        if (stop) break;
+    }
+    if (points.empty()) return;
+    points.back().velocity = 0;
+
+    const int n = points.size();
+    for (int i = 0; i < n; i++) {
+        Point& point = points.at(i);
+        const Point& prev = points.at(std::max(i - 1, 0));
+        const Point& next = points.at(std::min(i + 1, n - 1));
+        point.heading = std::atan2(next.y - prev.y, next.x - prev.x);
+        if (i > 0) point.distance = prev.distance + std::hypot(point.x - prev.x, point.y - prev.y);
+        // signed curvature of the circle through the neighbouring points
+        if (i > 0 && i < n - 1) {
+            const float cross = (point.x - prev.x) * (next.y - point.y) - (point.y - prev.y) * (next.x - point.x);
+            const float product = std::hypot(point.x - prev.x, point.y - prev.y) *
+                                  std::hypot(next.x - point.x, next.y - point.y) *
+                                  std::hypot(next.x - prev.x, next.y - prev.y);
+            if (product > 0) point.curvature = 2 * cross / product;
+        }
+        // the outer wheel can't go faster than the max velocity
+        point.velocity = std::min(point.velocity, maxVelocity / (1 + std::fabs(point.curvature) * trackWidth / 2));
+    }
+
+    // limit acceleration from the start, then deceleration to the end
+    points.front().velocity = std::min(points.front().velocity, std::fabs(startVelocity));
+    for (int i = 1; i < n; i++) {
+        const float ds = points.at(i).distance - points.at(i - 1).distance;
+        const float reachable = std::sqrt(points.at(i - 1).velocity * points.at(i - 1).velocity + 2 * maxAccel * ds);
+        points.at(i).velocity = std::min(points.at(i).velocity, reachable);
+    }
+    for (int i = n - 2; i >= 0; i--) {
+        const float ds = points.at(i + 1).distance - points.at(i).distance;
+        const float reachable = std::sqrt(points.at(i + 1).velocity * points.at(i + 1).velocity + 2 * maxAccel * ds);
+        points.at(i).velocity = std::min(points.at(i).velocity, reachable);
+    }
+
+    // time each point, assuming constant acceleration between points
+    for (int i = 1; i < n; i++) {
+        const float ds = points.at(i).distance - points.at(i - 1).distance;
+        const float avgVelocity = (points.at(i).velocity + points.at(i - 1).velocity) / 2;
+        points.at(i).time = points.at(i - 1).time + (avgVelocity > 0 ? ds / avgVelocity : 0);
+    }
+}
+
+atlas::TrajectoryState atlas::Trajectory::sample(float time) const {
+    if (points.empty()) return {lemlib::Pose(0, 0), 0, 0};
+
+    float x, y, heading, velocity, curvature;
+    if (time >= getDuration() || points.size() == 1) {
+        const Point& end = points.back();
+        x = end.x;
+        y = end.y;
+        heading = end.heading;
+        velocity = 0;
+        curvature = end.curvature;
+    } else {
+        time = std::max(time, 0.0f);
+        // find the pair of points the time is between
+        const auto next = std::upper_bound(points.begin(), points.end(), time,
+                                           [](float t, const Point& point) { return t < point.time; });
+        const Point& p1 = *next;
+        const Point& p0 = *(next - 1);
+        const float ds = p1.distance - p0.distance;
+        const float dt = time - p0.time;
+        const float accel = ds > 0 ? (p1.velocity * p1.velocity - p0.velocity * p0.velocity) / (2 * ds) : 0;
+        const float t = ds > 0 ? std::clamp((p0.velocity * dt + accel * dt * dt / 2) / ds, 0.0f, 1.0f) : 1;
+        x = p0.x + (p1.x - p0.x) * t;
+        y = p0.y + (p1.y - p0.y) * t;
+        heading = p0.heading + std::remainder(p1.heading - p0.heading, 2 * M_PI) * t;
+        velocity = p0.velocity + accel * dt;
+        curvature = p0.curvature + (p1.curvature - p0.curvature) * t;
+    }
+
+    // driving backwards, the robot faces away from the direction of travel
+    const float angularVelocity = velocity * curvature;
+    if (!forwards) return {lemlib::Pose(x, y, heading + M_PI), -velocity, angularVelocity};
+    return {lemlib::Pose(x, y, heading), velocity, angularVelocity};
+}
+
+float atlas::Trajectory::getDuration() const { return points.empty() ? 0 : points.back().time; }
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include "pros/error.h"
+#include "lemlib/util.hpp"
+#include "atlas/chassis/odom.hpp"
+#include "atlas/vision.hpp"
+
+// resolution and field of view of the AI Vision sensor
+constexpr float IMAGE_WIDTH = 320;
+constexpr float IMAGE_HEIGHT = 240;
+constexpr float HORIZONTAL_FOV = lemlib::degToRad(74);
+constexpr float VERTICAL_FOV = lemlib::degToRad(63);
+// the sensor sends about 30 frames a second, in ms
+constexpr std::uint32_t FRAME_PERIOD = 33;
+// detections further than this are too noisy to track, since a pixel covers several inches, in inches
+constexpr float MAX_RANGE = 72;
+// detections within this distance of a track are the same element, in inches
+constexpr float ASSOCIATION_RADIUS = 6;
+// how much each frame moves a track towards the detection
+constexpr float SMOOTHING = 0.5;
+// frames an element has to be seen in before it is returned, so one false detection is never driven to
+constexpr int MIN_HITS = 3;
+// tracks not seen for this long are dropped, in ms
+constexpr std::uint32_t TRACK_TIMEOUT = 500;
+
+atlas::VisionTracker::VisionTracker(pros::AIVision* sensor, CameraMount mount, float targetHeight)
+    : sensor(sensor),
+      mount(mount),
+      targetHeight(targetHeight) {}
+
+std::optional<lemlib::Pose> atlas::VisionTracker::project(const pros::AIVision::Object& object,
+                                                          lemlib::Pose pose) const {
+    // bottom center of the detection, where the element touches the floor
+    float u = 0;
+    float v = 0;
+    if (object.type == pros::E_AIVISION_DETECTED_TAG) {
+        const auto& tag = object.object.tag;
+        u = (tag.x0 + tag.x1 + tag.x2 + tag.x3) / 4.0f;
+        v = std::max({tag.y0, tag.y1, tag.y2, tag.y3});
+    } else if (object.type == pros::E_AIVISION_DETECTED_OBJECT) {
+        const auto& element = object.object.element;
+        u = element.xoffset + element.width / 2.0f;
+        v = element.yoffset + element.height;
+    } else {
+        const auto& color = object.object.color;
+        u = color.xoffset + color.width / 2.0f;
+        v = color.yoffset + color.height;
+    }
+
+    // direction of the pixel from the camera, with forwards as 1
+    const float right = (u - IMAGE_WIDTH / 2) / (IMAGE_WIDTH / 2) * std::tan(HORIZONTAL_FOV / 2);
+    const float down = (v - IMAGE_HEIGHT / 2) / (IMAGE_HEIGHT / 2) * std::tan(VERTICAL_FOV / 2);
+    // tilt it by the pitch of the camera
+    const float pitch = lemlib::degToRad(mount.pitch);
+    const float forward = std::cos(pitch) - down * std::sin(pitch);
+    const float drop = std::sin(pitch) + down * std::cos(pitch);
+    if (drop <= 0) return std::nullopt;
+    // follow the ray down to the element
+    const float scale = (mount.height - targetHeight) / drop;
+    const float distance = scale * std::hypot(forward, right);
+    if (scale <= 0 || distance > MAX_RANGE) return std::nullopt;
+
+    // turn by the direction the camera faces, then move from the camera to the field
+    const float angle = lemlib::degToRad(mount.angle);
+    const float localX = mount.xOffset + scale * (right * std::cos(angle) + forward * std::sin(angle));
+    const float localY = mount.yOffset + scale * (forward * std::cos(angle) - right * std::sin(angle));
+    const float s = std::sin(pose.theta);
+    const float c = std::cos(pose.theta);
+    return lemlib::Pose(pose.x + localX * c + localY * s, pose.y - localX * s + localY * c);
+}
+
+void atlas::VisionTracker::update(lemlib::Pose pose) {
+    // read into the fixed array, since get_all_objects allocates a vector every frame
+    const std::int32_t count = sensor->get_object_count();
+    if (count == PROS_ERR) return;
+    const int size = std::min(int(count), MAX_DETECTIONS);
+    for (int i = 0; i < size; i++) detections[i] = sensor->get_object(i);
+
+    const std::uint32_t now = pros::millis();
+    std::lock_guard<pros::Mutex> lock(mutex);
+    // forget elements that haven't been seen in a while. They were probably picked up
+    for (VisionTarget& track : tracks)
+        if (track.hits > 0 && now - track.lastSeen > TRACK_TIMEOUT) track.hits = 0;
+
+    for (int i = 0; i < size; i++) {
+        const std::optional<lemlib::Pose> position = project(detections[i], pose);
+        if (!position) continue;
+        // match the detection to the nearest track of the same element
+        VisionTarget* match = nullptr;
+        float matchDistance = ASSOCIATION_RADIUS;
+        for (VisionTarget& track : tracks) {
+            if (track.hits == 0 || track.id != detections[i].id) continue;
+            const float distance = std::hypot(track.x - position->x, track.y - position->y);
+            if (distance < matchDistance) {
+                match = &track;
+                matchDistance = distance;
+            }
+        }
+        if (match != nullptr) {
+            match->x = lemlib::ema(position->x, match->x, SMOOTHING);
+            match->y = lemlib::ema(position->y, match->y, SMOOTHING);
+            match->hits++;
+            match->lastSeen = now;
+            continue;
+        }
+        // start a new track, replacing the one seen longest ago if they're all in use
+        VisionTarget* slot = std::min_element(tracks.begin(), tracks.end(), [](const auto& a, const auto& b) {
+            if ((a.hits == 0) != (b.hits == 0)) return a.hits == 0;
+            return a.lastSeen < b.lastSeen;
+        });
+        *slot = {detections[i].id, position->x, position->y, 1, now};
+    }
+}
+
+std::optional<atlas::VisionTarget> atlas::VisionTracker::getNearest(std::uint8_t id, lemlib::Pose pose) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    std::optional<VisionTarget> nearest;
+    float nearestDistance = INFINITY;
+    for (const VisionTarget& track : tracks) {
+        if (track.id != id || track.hits < MIN_HITS) continue;
+        const float distance = std::hypot(track.x - pose.x, track.y - pose.y);
+        if (distance < nearestDistance) {
+            nearest = track;
+            nearestDistance = distance;
+        }
+    }
+    return nearest;
+}
+
+void atlas::VisionTracker::start() {
+    if (task != nullptr) return;
+    // below the odometry task, so tracking never delays odometry or the motions
+    task = new pros::Task {[this] {
+        std::uint32_t now = pros::millis();
+        while (true) {
+            update(atlas::getPose(true));
+            pros::Task::delay_until(&now, FRAME_PERIOD);
+        }
+    }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "vision tracker"};
+}
@@ -1,4 +1,15 @@
 #include "main.h"
 
 pros::Motor A7(15, pros::v5::MotorGears::blue);
-pros::Motor A8(16, pros::v5::MotorGears::blue);
\ No newline at end of file
+pros::Motor A8(16, pros::v5::MotorGears::blue);
+
+// jam detection for the blue intake motors
+atlas::IntakeSettings intake_settings(2000, // jam current, in mA
+                                      50, // jam velocity, in rpm
+                                      150, // time stalled before unjamming, in ms
+                                      150 // time spent reversing, in ms
+);
+
+// velocity control holds the intake speed when it's loaded with game elements
+atlas::Intake intake_stage1(&A7, intake_settings, atlas::IntakeMode::VELOCITY);
+atlas::Intake intake_stage2(&A8, intake_settings, atlas::IntakeMode::VELOCITY);
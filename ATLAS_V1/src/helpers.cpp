@@ -1,9 +1,9 @@
 #include "main.h"
 
 void stage1(int power1){
-    A7.move(power1);
+    intake_stage1.move(power1);
 }
 
 void stage2(int power2){
-    A8.move(power2);
-}
\ No newline at end of file
+    intake_stage2.move(power2);
+}
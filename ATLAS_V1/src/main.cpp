@@ -1,4 +1,5 @@
 #include "lemlib/api.hpp" // IWYU pragma: keep
+#include "atlas/api.hpp" // IWYU pragma: keep
 #include "main.h"
 #include "liblvgl/display/lv_display.h"
 #include "liblvgl/misc/lv_area.h"
@@ -13,6 +14,9 @@ pros::MotorGroup right_mg({14, 1, -12}, pros::MotorGearset::blue);
 //right_mg.set_gearing(pros::E_MOTOR_GEARSET_06);
 //left_mg.set_gearing(pros::E_MOTOR_GEARSET_06);
 
+// turns the drivetrain current down as it heats up, so it lasts the whole match
+atlas::PowerManager drive_power(&left_mg, &right_mg);
+
 // drivetrain settings
 lemlib::Drivetrain Drivetrain(&left_mg, // left motor group
                               &right_mg, // right motor group
@@ -23,15 +27,15 @@ lemlib::Drivetrain Drivetrain(&left_mg, // left motor group
 );
 
 // input curve for throttle input during driver control
-lemlib::ExpoDriveCurve throttle_curve(3, // joystick deadband out of 127
-                                     10, // minimum output where drivetrain will move out of 127
-                                     1.019 // expo curve gain  *1.019   #A
+constexpr atlas::LookupDriveCurve throttle_curve(3, // joystick deadband out of 127
+                                                 10, // minimum output where drivetrain will move out of 127
+                                                 1.019 // expo curve gain  *1.019   #A
 );
 
 // input curve for steer input during driver control
-lemlib::ExpoDriveCurve steer_curve(3, // joystick deadband out of 127
-                                  10, // minimum output where drivetrain will move out of 127
-                                  1.019 // expo curve gain *1.019   #A
+constexpr atlas::LookupDriveCurve steer_curve(3, // joystick deadband out of 127
+                                              10, // minimum output where drivetrain will move out of 127
+                                              1.019 // expo curve gain *1.019   #A
 );
 
 
@@ -50,11 +54,12 @@ lemlib::TrackingWheel horizontal_tracking_wheel(&horizontal_rotation_sensor, lem
 // vertical tracking wheel
 lemlib::TrackingWheel vertical_tracking_wheel(&vertical_rotation_sensor, lemlib::Omniwheel::NEW_2, 0.5);
 
-lemlib::OdomSensors sensors(&vertical_tracking_wheel, // vertical tracking wheel 1, set to null
+atlas::OdomSensors sensors(&vertical_tracking_wheel, // vertical tracking wheel 1, set to null
 							nullptr,
                             &horizontal_tracking_wheel, // horizontal tracking wheel 1
 							nullptr,
-                            &imu // inertial sensor
+                            &imu, // inertial sensor
+                            nullptr // no GPS sensor, set to null
 );
 
 
@@ -83,21 +88,64 @@ lemlib::ControllerSettings angular_controller(4, // proportional gain (kP)   2
 );
 
 
-lemlib::Chassis chassis(Drivetrain,
-                        lateral_controller,
-                        angular_controller,
-                        sensors,
-                        &throttle_curve, 
-                        &steer_curve
+// lateral settle exit, lets motions end as soon as the robot has stopped on target
+atlas::SettleSettings lateral_settle(1, // error range, in inches
+                                     30, // time settled before exiting, in milliseconds
+                                     2, // max speed while settled, in inches per second
+                                     40 // max acceleration while settled, in inches per second squared
+);
+
+// angular settle exit
+atlas::SettleSettings angular_settle(1, // error range, in degrees
+                                     30, // time settled before exiting, in milliseconds
+                                     10, // max speed while settled, in degrees per second
+                                     200 // max acceleration while settled, in degrees per second squared
+);
+
+// lateral motion profile for trajectories, limits are derived from the drivetrain rpm and wheel size
+atlas::ProfileSettings lateral_profile(0.9, // fraction of the theoretical max velocity to cruise at
+                                       0.4 // time to reach the cruise velocity, in seconds
+);
+
+// angular motion profile for turns and swings, limits are derived from the drivetrain rpm and track width
+atlas::ProfileSettings angular_profile(0.8, // fraction of the theoretical max turn rate to cruise at
+                                       0.25 // time to reach the cruise turn rate, in seconds
+);
+
+atlas::Chassis chassis(Drivetrain,
+                       lateral_controller,
+                       angular_controller,
+                       lateral_settle,
+                       angular_settle,
+                       lateral_profile,
+                       angular_profile,
+                       sensors,
+                       &throttle_curve, 
+                       &steer_curve
 );
 
 
 
 //Pneumatics
-pros::adi::Pneumatics descore({17, 'a'}, false);   
-pros::adi::Pneumatics park({17, 'b'}, false);  
-pros::adi::Pneumatics scraper({17, 'c'}, false);  
-pros::adi::Pneumatics redirect({17, 'd'}, false);  
+pros::adi::Pneumatics descore_piston({17, 'a'}, false);   
+pros::adi::Pneumatics park_piston({17, 'b'}, false);  
+pros::adi::Pneumatics scraper_piston({17, 'c'}, false);  
+pros::adi::Pneumatics redirect_piston({17, 'd'}, false);  
+
+// only send the expander a command when a piston changes
+atlas::CachedPneumatics descore(&descore_piston);
+atlas::CachedPneumatics park(&park_piston);
+atlas::CachedPneumatics scraper(&scraper_piston);
+atlas::CachedPneumatics redirect(&redirect_piston);
+
+// color sort, throws out game elements of the other alliance's color at the redirect. It owns the redirect, so move
+// the redirect with color_sort.setRedirect instead of the piston
+atlas::ColorSortSettings sort_settings(8, // distance from the optical sensor to the redirect, in inches   #A
+                                       2, // diameter of the intake roller, in inches   #A
+                                       200, // time the redirect stays switched, in milliseconds
+                                       100 // proximity where an element is in front of the sensor, out of 255
+);
+atlas::ColorSort color_sort(&color_sensor, &redirect, &intake_stage2, sort_settings);
 
 
 
@@ -175,9 +223,29 @@ void menu(void)
     lv_style_set_height(&style, LV_SIZE_CONTENT);
 }
 
+//ASSET(leftfirst_txt);
+ASSET(leftsecond_txt);
+//ASSET(park_path_txt);
+//ASSET(rightfirst_txt);
+ASSET(rightsecond_txt);
+
 void initialize() {
+	// calibrate in the background while the screen is set up and the paths are parsed
+	atlas::Calibration calibration = chassis.calibrate(true, true);
 	display_img_from_c_array();
-	chassis.calibrate();
+	atlas::preloadPath(leftsecond_txt);
+	atlas::preloadPath(rightsecond_txt);
+	calibration.waitUntilDone();
+	// keep the tuned gains valid as the battery drains over the match
+	chassis.setVoltageCompensation(12600); // #A     battery voltage the PIDs were tuned at, in mV
+	// the compensation needs the current a sagging battery can give, so only heat turns the drive down
+	drive_power.setVoltageCompensated(true);
+	// the intakes check for jams in the background, in autonomous and driver control
+	intake_stage1.start();
+	intake_stage2.start();
+	color_sort.reject(atlas::GameColor::BLUE); // #A     set to the other alliance's color
+	color_sort.start();
+	drive_power.start();
 }
 
 /**
@@ -209,11 +277,6 @@ void competition_initialize() {}
  * will be stopped. Re-enabling the robot will restart the task, not re-start it
  * from where it left off.
  */
-//ASSET(leftfirst_txt);
-ASSET(leftsecond_txt);
-//ASSET(park_path_txt);
-//ASSET(rightfirst_txt);
-ASSET(rightsecond_txt);
 void autonomous() {
 
     // left auto
@@ -222,13 +285,13 @@ void autonomous() {
     chassis.turnToHeading(90, 2000);
     chassis.moveToPose(-22.2, 23, 3000);
     stage1(127);
-    scraper.set_value(true);
+    scraper.set(true);
     chassis.turnToHeading(315, 2000);
     chassis.moveToPose(-8.451, 8.031, 315, 4000);
     stage2(127);
     chassis.waitUntil(5);
     stage2(0);
-    chassis.follow(leftsecond_txt, 15, 5000);
+    chassis.follow(leftsecond_txt, 15, 5000, true, {.minLookahead = 8, .maxLookahead = 18});
     chassis.moveToPoint(-25.305, 47.48, 2000, {.forwards = false}); 
     stage2(127);
     chassis.waitUntil(10);
@@ -240,7 +303,7 @@ void autonomous() {
     //chassis.turnToHeading(90, 2000);
     //chassis.moveToPose(-22.2, -23, 3000);
     //stage1(127);
-    //scraper.set_value(true);
+    //scraper.set(true);
     //chassis.turnToHeading(225, 2000);
     //chassis.moveToPose(-8.451, -8.031, 45, 4000);
     //stage2(127);
@@ -282,12 +345,12 @@ void autonomous() {
 	//stage1(127);
 	//chassis.follow(leftfirst_txt, 15, 3000);
 	//chassis.moveToPose(-7.864, 9, 316, 3000, {.forwards = false});
-	//redirect.set_value(false);
+	//redirect.set(false);
     //chassis.waitUntil(27);
 	//stage2(127); 
 	//chassis.waitUntil(1);
-	//scraper.set_value(true);
-	//redirect.set_value(false);
+	//scraper.set(true);
+	//redirect.set(false);
 	//chassis.follow(leftsecond_txt, 15, 5000);
 	//stage2(0);
 	//stage1(127);
@@ -307,15 +370,15 @@ void autonomous() {
     //chassis.moveToPose(-62.611, 0);
 
     //right (run separately)
-    //scraper.set_value(false);
-    //redirect.set_value(true);
-    //descore.set_value(false);
+    //scraper.set(false);
+    //redirect.set(true);
+    //descore.set(false);
     //chassis.setPose(-62.294, 16.647, 180);
     //turnToHeading(165, 2000);
     //stage1(127); 
     //chassis.follow(rightfirst_txt, 15, 5000);
     //chassis.turnToHeading(210, 3000);
-    //scraper.set_value(true);
+    //scraper.set(true);
     //chassis.follow(rightsecond_txt, 15, 6000);
     //wait(15);
     //chassis.moveToPose(-23.798, -47.352, 270, 5000);
@@ -348,79 +411,34 @@ void autonomous() {
 
 void opcontrol() {
 	
-	
+	atlas::ControllerInput input(&master);
+	// driver controls. Hold bindings for the same intake stage are checked in order, so R1 wins over L1
+	atlas::ButtonBindings bindings({
+		{pros::E_CONTROLLER_DIGITAL_R1, atlas::Trigger::HOLD, stage1, 127},
+		{pros::E_CONTROLLER_DIGITAL_L1, atlas::Trigger::HOLD, stage1, -127},
+		{pros::E_CONTROLLER_DIGITAL_R2, atlas::Trigger::HOLD, stage2, 127},
+		{pros::E_CONTROLLER_DIGITAL_L2, atlas::Trigger::HOLD, stage2, -127},
+		{pros::E_CONTROLLER_DIGITAL_DOWN, atlas::Trigger::PRESS, [](int) { descore.toggle(); }},
+		{pros::E_CONTROLLER_DIGITAL_RIGHT, atlas::Trigger::PRESS, [](int) { park.toggle(); }},
+		{pros::E_CONTROLLER_DIGITAL_Y, atlas::Trigger::PRESS, [](int) { scraper.toggle(); }},
+		{pros::E_CONTROLLER_DIGITAL_B, atlas::Trigger::PRESS, [](int) { color_sort.toggleRedirect(); }},
+	});
+	// back off a side whose wheels spin out, like on a push. Off until the slip speed is tuned
+	// chassis.setTractionControl(atlas::TractionSettings(8, 0.1, 0.05, 0.5)); // #A     tune slip speed
+	// drive straight while the turn stick is centered. Off until the gains are tuned
+	// chassis.setHeadingHold(lemlib::PID(3, 0, 15)); // #A     tune kP and kD
 	while (true) {
 	
-        int power = master.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y); 
-        int turn = master.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_X);
+        // read the whole controller once, so the update acts on one snapshot
+        const atlas::ControllerState& state = input.read();
+ 
+	 	chassis.arcade(state.leftY, state.rightX, false, 0.65); // #A     change num
 
+		// intake and pneumatics only get a command when a button changes what they should do
+		bindings.update(state);
 
-        int left = power + turn;
-        int right = power - turn;
-		
- 
-	 	chassis.arcade(power, turn, false, 0.65); // #A     change num
-
-
-		if(master.get_digital(pros::E_CONTROLLER_DIGITAL_R1)) {
-			stage1(127);
-		}
-
-		else if(master.get_digital(pros::E_CONTROLLER_DIGITAL_L1)) {
-			stage1(-127);
-		}
-
-		else{
-			stage1(0);
-		}
-
-		if(master.get_digital(pros::E_CONTROLLER_DIGITAL_R2)) {
-			stage2(127);
-		}
-
-		else if(master.get_digital(pros::E_CONTROLLER_DIGITAL_L2)) {
-			stage2(-127);
-		}
-
-		else{
-			stage2(0);
-		}
-
-		if(master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_DOWN)) {
-       		descore.toggle();
-		}
-
-		if(master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_RIGHT)) {
-       		park.toggle();
-		}
-
-		if(master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_Y)) {
-       		scraper.toggle();
-		}
-
-		if(master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_B)) {
-       		redirect.toggle();
-		}
-
-		// Turn on the sensor's LED for better results in low light
-        //color_sensor.set_led_brightness(100); 
-
-        // Check if the detected color is red
-        //if (color_sensor.color() == vex::color::red) {
-            
-            // e.g., intake.move_voltage(12000); 
-        //} 
-        // Check if the detected color is blue
-        //else if (color_sensor.color() == vex::color::blue) {
-            // Code to run when blue is detected
-            // e.g., intake.move_voltage(-12000); // Reverse the intake
-        //} 
-        // If neither color is detected, stop or do something else
-        //else {
-		
-        //}
-        // A small delay is necessary to prevent the brain from overloading
-        pros::delay(21); 
-	} 	                         // Run for 20 ms then update                        // Run for 20 ms then update
+        // wait for the next controller update, a fixed period after the last one
+        input.wait();
+	}
 	
 }
\ No newline at end of file